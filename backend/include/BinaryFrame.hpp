@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DrawCommand.hpp"
+
+/// Compact binary form of one DrawCommand frame, used by local transports
+/// that skip JSON. All fields are host byte order; strings are a u16 length
+/// plus bytes, and each vertex array is a u32 float count followed by the
+/// floats, 4-byte aligned from the frame start so readers can use them in place.
+///
+///   u32 magic, u32 commandCount, u64 version, i64 ingestUs, i64 genEndUs,
+///   str source, then per command:
+///   str type, label, pane, seriesId, style type, color, altColor, wickColor,
+///   f32 thickness, u32 n, pad, f32 vertices[n]
+struct BinaryFrame {
+    std::string source;          // SeriesStore id the commands were generated from
+    uint64_t    version  = 0;    // store version of that snapshot
+    int64_t     ingestUs = 0;    // see FrameTrace
+    int64_t     genEndUs = 0;
+    std::vector<ChartingApp::DrawCommand> commands;
+};
+
+constexpr uint32_t kBinaryFrameMagic = 0x32464443;  // "CDF2"
+
+/// Replaces the contents of `out` with the encoded frame
+void encodeBinaryFrame(const BinaryFrame& frame, std::vector<uint8_t>& out);
+
+/// Returns false if `data` is not a complete, well-formed frame
+bool decodeBinaryFrame(const uint8_t* data, size_t size, BinaryFrame& out);
@@ -13,6 +13,7 @@ struct DrawCommand {
     std::string seriesId;   // identifier for the series ("price", "ohlc")
     std::vector<float> vertices; // flattened vertex list: [x0,y0, x1,y1, ...]
     struct Style {
+        std::string type;      // generator that laid out the vertices ("line", "candlestick")
         std::string color;     // primary color (e.g. "#00ff00")
         std::string altColor;  // secondary color (e.g. "#ff0000" for down candles)
         std::string wickColor; // wick color for candlesticks
@@ -20,4 +21,12 @@ struct DrawCommand {
     } style;
 };
 
+// Replaces part of the vertices of a command from the last full frame
+struct SeriesPatch {
+    size_t index;                // position of the command in that frame
+    std::string seriesId;
+    size_t offset;               // in floats; offset + size may extend the series
+    std::vector<float> vertices;
+};
+
 } // namespace ChartingApp
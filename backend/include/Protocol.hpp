@@ -2,11 +2,55 @@
 #define PROTOCOL_HPP
 
 #include <string>
+#include <vector>
+#include "DrawCommand.hpp"
+#include "Tracing.hpp"
+#include "thumbnails/ThumbnailCache.hpp"
 
 class Protocol {
 public:
     // Accepts chartType and raw JSON array string, returns DrawCommand or error JSON
     static std::string processRequest(const std::string& chartType, const std::string& jsonArrayStr);
+
+    // Wraps commands in the { type:"drawCommands", commands:[...] } envelope,
+    // tagged with the client's subscription id and sequence number when given
+    static std::string serializeDrawCommands(const std::vector<ChartingApp::DrawCommand>& commands,
+                                             const std::string& subscriptionId = "",
+                                             uint64_t seq = 0);
+
+    // { type:"patchSeries", patches:[{ index, seriesId, offset, vertices }] }: replaces
+    // vertices [offset, offset + n) of command `index` from the last drawCommands frame
+    static std::string serializePatches(const std::vector<ChartingApp::SeriesPatch>& patches,
+                                        const std::string& subscriptionId = "",
+                                        uint64_t seq = 0);
+
+    // Reads the {"subscriptionId":"..","seq":N, prefix our serializers put first,
+    // without parsing the rest; `bodyPos` is where the remaining members start.
+    // False if the frame has no subscription id (or an escaped one).
+    static bool splitEnvelope(const std::string& frame, std::string& subscriptionId,
+                              uint64_t& seq, size_t& bodyPos);
+
+    // Inverse of splitEnvelope: prefixes a frame body with a new id and seq
+    static std::string wrapBody(const std::string& body, const std::string& subscriptionId = "",
+                                uint64_t seq = 0);
+
+    // Appends "trace":{ ingest, genStart, genEnd, enqueue } to a serialized
+    // frame in place, so the enqueue stamp can be taken after serialization
+    static void appendTrace(std::string& frame, const FrameTrace& trace);
+
+    // { type:"stats", subscriptions:[{ subscriptionId, framesSent, framesAcked, pipeline, rtt, endToEnd }] }
+    static std::string serializeStats(const std::vector<SubscriptionStats>& stats,
+                                      const std::string& subscriptionId = "");
+
+    // { type:"error", message } for a request or a single subscription
+    static std::string serializeError(const std::string& message, const std::string& subscriptionId = "");
+
+    // { type:"unsubscribed", subscriptionId } confirming a cancelled subscription
+    static std::string serializeUnsubscribed(const std::string& subscriptionId);
+
+    // { type:"thumbnails", images:[{ source, version, png (base64) } | { source, error }] }
+    static std::string serializeThumbnails(const std::vector<Thumbnail>& thumbnails,
+                                           const std::string& subscriptionId = "");
 };
 
 #endif // PROTOCOL_HPP
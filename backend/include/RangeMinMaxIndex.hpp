@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/// Segment tree over the (low, high) columns of an append-only bar series.
+/// Answers "min low / max high over bars [first, last]" in O(log n); an
+/// append or an in-place update of one bar costs O(log n) too. Capacity
+/// doubles as the series grows, rebuilding the inner nodes in O(n), so
+/// appends stay amortized O(log n).
+class RangeMinMaxIndex {
+public:
+    size_t size() const { return size_; }
+
+    void clear() {
+        size_ = cap_ = 0;
+        low_.clear();
+        high_.clear();
+    }
+
+    void push(double low, double high) {
+        if (size_ == cap_) grow();
+        set(size_++, low, high);
+    }
+
+    /// Updates bar `i` (< size()) in place, e.g. the forming bar
+    void set(size_t i, double low, double high) {
+        size_t n = cap_ + i;
+        low_[n]  = low;
+        high_[n] = high;
+        for (n >>= 1; n >= 1; n >>= 1) {
+            low_[n]  = std::min(low_[2 * n],  low_[2 * n + 1]);
+            high_[n] = std::max(high_[2 * n], high_[2 * n + 1]);
+        }
+    }
+
+    /// Min low and max high over bars [first, last], both < size()
+    void query(size_t first, size_t last, double& low, double& high) const {
+        low  = kEmptyLow;
+        high = kEmptyHigh;
+        for (size_t l = first + cap_, r = last + cap_ + 1; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) {
+                low  = std::min(low,  low_[l]);
+                high = std::max(high, high_[l]);
+                ++l;
+            }
+            if (r & 1) {
+                --r;
+                low  = std::min(low,  low_[r]);
+                high = std::max(high, high_[r]);
+            }
+        }
+    }
+
+private:
+    static constexpr double kEmptyLow  = std::numeric_limits<double>::infinity();
+    static constexpr double kEmptyHigh = -std::numeric_limits<double>::infinity();
+
+    void grow() {
+        const size_t cap = cap_ ? cap_ * 2 : 64;
+        std::vector<double> low(2 * cap, kEmptyLow), high(2 * cap, kEmptyHigh);
+        for (size_t i = 0; i < size_; ++i) {
+            low[cap + i]  = low_[cap_ + i];
+            high[cap + i] = high_[cap_ + i];
+        }
+        for (size_t n = cap - 1; n >= 1; --n) {
+            low[n]  = std::min(low[2 * n],  low[2 * n + 1]);
+            high[n] = std::max(high[2 * n], high[2 * n + 1]);
+        }
+        low_.swap(low);
+        high_.swap(high);
+        cap_ = cap;
+    }
+
+    size_t              size_ = 0;
+    size_t              cap_  = 0;   // leaves; leaf i lives at node cap_ + i
+    std::vector<double> low_;
+    std::vector<double> high_;
+};
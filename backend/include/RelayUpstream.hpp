@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+/// A live frame received from upstream with its envelope stripped: `body`
+/// starts at the "type" member, so relaying it to a local subscriber only
+/// takes a new {"subscriptionId":..,"seq":.., prefix, never a re-encode.
+struct RelayFrame {
+    enum class Kind { Full, Patch, Other };
+    Kind        kind = Kind::Other;
+    std::string body;
+};
+using RelayFramePtr = std::shared_ptr<const RelayFrame>;
+
+/// What a live subscription asks for. Local subscriptions with equal keys
+/// share one upstream subscription.
+struct RelayChannelKey {
+    std::string              source;
+    std::vector<std::string> seriesTypes;
+    bool                     patch = false;
+    int64_t                  fromT = INT64_MIN;
+    int64_t                  toT   = INT64_MAX;
+
+    /// Map key: equal only for equal requests (strings are length-prefixed)
+    std::string str() const;
+};
+
+/// Relay mode: serves live subscriptions from another chart_server instead
+/// of the local SeriesStore. Multiplexed WebSocket connections ("links")
+/// carry a single upstream subscription per distinct channel, however many
+/// local viewers share it, so the origin's load does not grow with relay
+/// fan-out. A link holds at most as many channels as the origin allows per
+/// connection; further links are opened on demand, up to a fixed total.
+/// Windowed subscriptions are channels of their own (the vertices depend on
+/// the window), so viewers panning independently each cost one channel.
+///
+/// Each channel caches the last full frame and the patches since, which is
+/// what a new local subscriber is sent first. The relay folds the patches
+/// into the cached frame itself once there are many, so the cache stays
+/// bounded without another full frame from upstream. Upstream sequence
+/// numbers are checked; after a gap or a reconnect, patches are dropped
+/// until a fresh full frame arrives (the channel is re-subscribed to get
+/// one). A channel whose subscribe is refused gets the error relayed to its
+/// viewers and is closed.
+///
+/// All channel state lives on the relay's own io thread, which never blocks:
+/// connecting is asynchronous with a deadline. Listeners are invoked there
+/// and must hand frames off (e.g. post to their session).
+class RelayUpstream {
+public:
+    using Listener = std::function<void(const RelayFramePtr&)>;
+
+    static RelayUpstream& instance();
+
+    /// Starts the relay thread and connects; reconnects for the process lifetime
+    void start(const std::string& host, unsigned short port);
+    bool enabled() const { return running_.load(); }
+
+    /// Joins (or opens) the channel for `key`; the cached state is replayed to
+    /// `listener` before any new frame. Returns a token for detach()/replay().
+    uint64_t attach(const RelayChannelKey& key, Listener listener);
+    void     detach(uint64_t token);
+
+    /// Re-sends the cached full frame and patches to one listener, e.g. after
+    /// its session had to drop frames for a slow client
+    void     replay(uint64_t token);
+
+private:
+    using Stream = boost::beast::websocket::stream<boost::asio::ip::tcp::socket>;
+
+    /// One upstream connection. Every connection attempt bumps `generation`;
+    /// completions of an older one are ignored, and they own their stream,
+    /// read buffer and in-flight message, so nothing is freed under them.
+    struct Link {
+        Link(boost::asio::io_context& ioc, size_t index, size_t capacity)
+            : index(index), resolver(ioc), timer(ioc), capacity(capacity) {}
+
+        size_t                                     index;
+        boost::asio::ip::tcp::resolver             resolver;
+        boost::asio::steady_timer                  timer;      // connect deadline, then reconnect delay
+        std::shared_ptr<Stream>                    ws;
+        std::shared_ptr<boost::beast::flat_buffer> readBuf;
+        std::deque<std::string>                    outbox;
+        uint64_t                                   generation = 0;
+        bool                                       connected  = false;
+        bool                                       writing    = false;
+        unsigned                                   failures   = 0;
+        size_t                                     channels   = 0;
+        size_t                                     capacity;   // lowered if upstream refuses a subscribe
+    };
+
+    struct Channel {
+        std::string                            upstreamId;
+        std::string                            subscribeMsg;
+        Link*                                  link = nullptr;
+        std::unordered_map<uint64_t, Listener> listeners;
+        RelayFramePtr                          full;
+        std::vector<RelayFramePtr>             patches;         // since `full`
+        bool                                   cacheComplete = false;
+        bool                                   synced        = false;  // patches apply on top of `full`
+        bool                                   resyncPending = false;
+        uint64_t                               lastSeq       = 0;
+    };
+
+    RelayUpstream() = default;
+
+    Link* linkWithRoom();
+    void  connect(Link& link);
+    void  connectFailed(Link& link, const std::string& why);
+    void  onConnected(Link& link);
+    void  scheduleReconnect(Link& link);
+    void  onDisconnect(Link& link, const std::string& why);
+    void  doRead(Link& link);
+    void  handleFrame(const std::string& frame);
+    void  sendUpstream(Link& link, std::string msg);
+    void  doWrite(Link& link);
+    void  requestResync(Channel& ch);
+    void  compact(Channel& ch);
+    void  closeChannel(const std::string& upstreamId);
+    static void deliverCache(const Channel& ch, const Listener& listener);
+
+    boost::asio::io_context                                    ioc_{1};
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+                                                               work_{ioc_.get_executor()};
+    std::vector<std::unique_ptr<Link>>                         links_;
+
+    std::string                                                host_;
+    unsigned short                                             port_ = 0;
+    std::atomic<bool>                                          running_{false};
+    std::atomic<uint64_t>                                      nextToken_{1};
+    uint64_t                                                   nextChannel_ = 1;
+
+    std::unordered_map<std::string, Channel>                   channels_;   // by upstream id
+    std::unordered_map<std::string, std::string>               byKey_;      // key -> upstream id
+    std::unordered_map<uint64_t, std::string>                  byToken_;    // listener -> upstream id
+};
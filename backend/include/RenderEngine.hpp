@@ -22,6 +22,30 @@ struct OhlcPoint {
     double  high;
     double  low;
     double  close;
+    double  volume = 0.0; // summed tick size; 0 for bars loaded from JSON
+};
+
+/// Range a generator normalizes OHLC bars against. Vertices it produced stay
+/// valid only while the range is unchanged, so tail patches require a match.
+struct SeriesBounds {
+    int64_t minT = 0;
+    int64_t maxT = 0;
+    double  minP = 0.0;
+    double  maxP = 0.0;
+
+    bool operator==(const SeriesBounds& o) const {
+        return minT == o.minT && maxT == o.maxT && minP == o.minP && maxP == o.maxP;
+    }
+    bool operator!=(const SeriesBounds& o) const { return !(*this == o); }
+};
+
+/// What a live subscriber last received for one series type, so the next
+/// update can be sent as a patch against it
+struct RenderedSeries {
+    std::string        seriesType;
+    SeriesBounds       bounds;
+    size_t             barCount = 0;
+    std::vector<float> lastBar;   // vertices of the last bar as sent
 };
 
 /// Knows how to load DataPoint’s from JSON and turn them into DrawSeriesCommand’s
@@ -43,4 +67,21 @@ public:
     // New: incremental generation from `fromIndex` (0-based)
     static std::vector<DrawCommand> generateIncrementalDrawCommands(const std::string& seriesType, const std::string& jsonArrayStr, size_t fromIndex);
 
+    /// Renders in-memory bars (e.g. a SeriesStore snapshot) with the generator for `seriesType`
+    static std::vector<DrawCommand> generateBarDrawCommands(const std::string& seriesType, const std::string& seriesId, const std::vector<OhlcPoint>& bars);
+
+    /// Full render of `bars` for each of `seriesTypes`; `rendered` records what the client now holds.
+    /// `knownBounds`, if given, is the time/price range of `bars` and spares generators their pre-pass.
+    static std::vector<DrawCommand> renderLiveBars(const std::vector<std::string>& seriesTypes, const std::string& seriesId,
+                                                   const std::vector<OhlcPoint>& bars, std::vector<RenderedSeries>& rendered,
+                                                   const SeriesBounds* knownBounds = nullptr);
+
+    /// Patches that bring a client holding `rendered` up to `bars`, re-generating only the bars
+    /// that can have changed since. Returns false (leaving `rendered` as is) when only a full
+    /// frame will do: nothing sent yet, the normalization range moved, or most bars changed.
+    static bool patchLiveBars(const std::vector<std::string>& seriesTypes, const std::string& seriesId,
+                              const std::vector<OhlcPoint>& bars, std::vector<RenderedSeries>& rendered,
+                              std::vector<ChartingApp::SeriesPatch>& patches,
+                              const SeriesBounds* knownBounds = nullptr);
+
 };
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RangeMinMaxIndex.hpp"
+#include "RenderEngine.hpp"
+
+/// Process-wide store of live OHLC series, keyed by seriesId.
+///
+/// Writers publish bars; a bar whose timestamp matches the last stored bar
+/// replaces it in place (the forming bar), a newer one is appended. Every
+/// publish bumps the series version and notifies its listeners.
+///
+/// Each series also keeps a RangeMinMaxIndex over its bars, so the price
+/// range of any time window is available in O(log n) without a scan.
+class SeriesStore {
+public:
+    /// Called after a publish, from the publishing thread, without the store lock held
+    using Listener = std::function<void(const std::string& seriesId, uint64_t version)>;
+
+    static SeriesStore& instance();
+
+    /// Append or update-in-place each of `bars` (in timestamp order), then notify once.
+    /// `ingestUs` is when the oldest data in this publish arrived (monotonicMicros),
+    /// or 0 if unknown; it is kept for frame latency tracing.
+    void publishBars(const std::string& seriesId, const std::vector<OhlcPoint>& bars, int64_t ingestUs = 0);
+
+    /// Copy of all bars currently held for `seriesId` (empty if unknown)
+    std::vector<OhlcPoint> snapshot(const std::string& seriesId, uint64_t* version = nullptr,
+                                    int64_t* ingestUs = nullptr) const;
+
+    /// Bars with t0 <= timestamp <= t1, located by binary search, plus their
+    /// normalization range from the index: O(log n) on top of the copy.
+    /// `ingestUs` is the earliest ingest time of the publishes after
+    /// `sinceVersion` (the version the caller last rendered), so a frame that
+    /// merges several publishes is traced from its oldest tick; 0 means just
+    /// the latest publish.
+    std::vector<OhlcPoint> snapshotRange(const std::string& seriesId, int64_t t0, int64_t t1,
+                                         SeriesBounds* bounds, uint64_t* version = nullptr,
+                                         int64_t* ingestUs = nullptr, uint64_t sinceVersion = 0) const;
+
+    /// Like snapshotRange(), for the last `maxBars` bars (all of them if 0)
+    std::vector<OhlcPoint> snapshotLast(const std::string& seriesId, size_t maxBars,
+                                        SeriesBounds* bounds, uint64_t* version = nullptr,
+                                        int64_t* ingestUs = nullptr, uint64_t sinceVersion = 0) const;
+
+    /// Time and price range (min low, max high) of the bars in [t0, t1] in
+    /// O(log n); false if the window holds no bars
+    bool priceRange(const std::string& seriesId, int64_t t0, int64_t t1, SeriesBounds& out) const;
+
+    /// Current version of `seriesId`; 0 if nothing was published yet
+    uint64_t version(const std::string& seriesId) const;
+
+    /// Registers a listener for `seriesId`, returns a token for removeListener()
+    uint64_t addListener(const std::string& seriesId, Listener listener);
+    void     removeListener(uint64_t token);
+
+private:
+    struct Series {
+        std::vector<OhlcPoint> bars;
+        RangeMinMaxIndex       range;         // low/high of `bars`, same order
+        uint64_t               version  = 0;
+        std::deque<int64_t>    ingests;       // ingestUs of the latest publishes, newest (= version) last
+    };
+
+    /// Publishes remembered per series for ingestSince(); a caller further
+    /// behind gets the oldest one kept
+    static constexpr size_t kIngestHistory = 256;
+
+    static int64_t ingestSince(const Series& s, uint64_t sinceVersion);
+
+    /// Index range [first, last) of the bars of `s` inside [t0, t1]
+    static void window(const Series& s, int64_t t0, int64_t t1, size_t& first, size_t& last);
+    static SeriesBounds boundsOf(const Series& s, size_t first, size_t last);
+    struct Registration {
+        std::string seriesId;
+        Listener    listener;
+    };
+
+    mutable std::mutex                         mutex_;
+    std::unordered_map<std::string, Series>    series_;
+    std::unordered_map<uint64_t, Registration> listeners_;
+    uint64_t                                   nextToken_ = 1;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ShmRing.hpp"
+
+struct ShmPublisherConfig {
+    std::string              name;                 // POSIX shm name, e.g. "/chart_frames"
+    uint32_t                 slotCount = 64;
+    uint32_t                 slotBytes = 256 * 1024;
+    std::vector<std::string> sources;              // SeriesStore ids to publish
+    std::vector<std::string> seriesTypes;          // generators run per source
+    size_t                   maxBars   = 4096;     // trailing bars per frame, 0 = all history
+};
+
+/// Shared-memory transport for consumers on the same host. Listens to
+/// SeriesStore for the configured sources and, on its own thread, renders
+/// each changed source once and writes it into the ring as a BinaryFrame.
+/// Bursts of publishes coalesce into one frame per source, and the cost per
+/// frame does not depend on how many readers follow the ring. Frames hold
+/// the last `maxBars` bars, so they keep fitting a slot as history grows.
+class ShmPublisher {
+public:
+    explicit ShmPublisher(ShmPublisherConfig config);
+    ~ShmPublisher();
+
+    /// Creates the ring and starts publishing; false (logged) on failure
+    bool start();
+    void stop();
+
+    uint64_t framesPublished() const { return framesPublished_.load(std::memory_order_relaxed); }
+    uint64_t framesTooLarge()  const { return framesTooLarge_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void markDirty(const std::string& source);
+    void publish(const std::string& source);
+
+    const ShmPublisherConfig config_;
+    ShmRingWriter            ring_;
+    std::vector<uint64_t>    storeTokens_;
+    std::vector<uint8_t>     encoded_;    // reused across frames
+    std::unordered_map<std::string, uint64_t> renderedVersion_;  // per source, worker thread only
+
+    std::mutex               mutex_;
+    std::condition_variable  wake_;
+    std::set<std::string>    dirty_;
+    bool                     stopping_ = false;
+
+    std::atomic<bool>        running_{false};
+    std::atomic<uint64_t>    framesPublished_{0};
+    std::atomic<uint64_t>    framesTooLarge_{0};
+    std::thread              worker_;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CHART_HAS_SHM 1
+#endif
+
+/// Broadcast ring of variable-size frames in a POSIX shared-memory object.
+///
+/// One writer process owns the object; any number of readers map it
+/// read-only and follow the writer at their own pace. Readers never write to
+/// the mapping, so adding one costs the writer nothing. Each slot carries a
+/// sequence stamp that works as a per-slot seqlock: odd while the writer is
+/// copying frame n into it, even once frame n is complete. A reader that
+/// falls more than a ring behind, or sees the stamp change under its copy,
+/// skips ahead and counts the lost frames as overruns.
+///
+/// Layout: [ShmRingHeader][slot 0]...[slot N-1], each slot a ShmSlotHeader
+/// followed by `slotBytes` of payload, padded to a cache line.
+
+constexpr uint32_t kShmRingMagic         = 0x43525348;  // "HSRC"
+constexpr uint32_t kShmRingLayoutVersion = 1;
+
+struct ShmRingHeader {
+    std::atomic<uint32_t> magic;       // stored last by the writer, once the header is valid
+    uint32_t              layoutVersion;
+    uint32_t              slotCount;
+    uint32_t              slotBytes;   // max payload per frame
+    uint64_t              slotStride;  // bytes from one slot header to the next
+    alignas(64) std::atomic<uint64_t> writeSeq;  // frames published so far
+};
+
+struct ShmSlotHeader {
+    std::atomic<uint64_t> stamp;      // 2n+1 while writing frame n, 2n+2 once written
+    uint32_t              size;
+    uint32_t              reserved;
+    int64_t               publishUs;  // monotonicMicros() when the writer finished the copy
+    int64_t               reserved2;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory ring needs address-free 64-bit atomics");
+
+/// Metadata of a frame handed out by ShmRingReader
+struct ShmFrameInfo {
+    uint64_t seq       = 0;
+    int64_t  publishUs = 0;
+};
+
+/// Creates (replacing any stale object of the same name) and publishes into a
+/// ring. Single writer: write() must only be called from one thread.
+class ShmRingWriter {
+public:
+    ShmRingWriter() = default;
+    ~ShmRingWriter();
+
+    ShmRingWriter(const ShmRingWriter&)            = delete;
+    ShmRingWriter& operator=(const ShmRingWriter&) = delete;
+
+    /// `name` is a POSIX shm name such as "/chart_frames". Returns false and
+    /// sets `error` on failure (or always, on platforms without POSIX shm).
+    bool create(const std::string& name, uint32_t slotCount, uint32_t slotBytes, std::string& error);
+
+    /// Publishes one frame. Returns false if it does not fit in a slot.
+    bool write(const uint8_t* data, size_t size);
+
+    uint32_t slotBytes() const { return slotBytes_; }
+
+private:
+    void close();
+
+    std::string    name_;
+    uint8_t*       base_      = nullptr;
+    size_t         mapSize_   = 0;
+    ShmRingHeader* header_    = nullptr;
+    uint32_t       slotCount_ = 0;
+    uint32_t       slotBytes_ = 0;
+    uint64_t       stride_    = 0;
+};
+
+/// Read-only view of a ring created by ShmRingWriter. next() never blocks and
+/// makes no system calls; callers decide how to wait when it returns false.
+class ShmRingReader {
+public:
+    ShmRingReader() = default;
+    ~ShmRingReader();
+
+    ShmRingReader(const ShmRingReader&)            = delete;
+    ShmRingReader& operator=(const ShmRingReader&) = delete;
+
+    /// Maps an existing ring. With `fromStart` the reader begins at the oldest
+    /// frame still in the ring, otherwise only frames published after open().
+    bool open(const std::string& name, bool fromStart, std::string& error);
+
+    /// Copies the next frame into `out`. Returns false when caught up.
+    bool next(std::vector<uint8_t>& out, ShmFrameInfo* info = nullptr);
+
+    /// Frames published but not yet read (an overrun is pending above slotCount)
+    uint64_t backlog() const;
+
+    /// Frames this reader lost because the writer lapped it
+    uint64_t overruns() const { return overruns_; }
+
+private:
+    void close();
+    const ShmSlotHeader* slotAt(uint64_t seq) const;
+    uint64_t             oldestAvailable(uint64_t writeSeq) const;
+
+    const uint8_t*       base_      = nullptr;
+    size_t               mapSize_   = 0;
+    const ShmRingHeader* header_    = nullptr;
+    uint32_t             slotCount_ = 0;
+    uint32_t             slotBytes_ = 0;
+    uint64_t             stride_    = 0;
+    uint64_t             nextSeq_   = 0;
+    uint64_t             overruns_  = 0;
+};
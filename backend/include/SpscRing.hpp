@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/// Bounded lock-free ring buffer for exactly one producer thread and one
+/// consumer thread. Capacity is rounded up to a power of two.
+///
+/// Each side keeps a private copy of the other side's index and only reloads
+/// the shared atomic when that copy says the ring looks full/empty, so the
+/// steady state touches no shared cache line per element.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : mask_(roundUpPow2(capacity < 2 ? 2 : capacity) - 1),
+          slots_(mask_ + 1) {}
+
+    SpscRing(const SpscRing&)            = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /// Producer only. Returns false when the ring is full.
+    bool tryPush(const T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) return false;
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Producer only. Pushes up to `count` items, returns how many fit.
+    size_t pushBulk(const T* items, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t room = capacity() - (tail - cachedHead_);
+        if (room < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            room = capacity() - (tail - cachedHead_);
+        }
+        const size_t n = count < room ? count : room;
+        for (size_t i = 0; i < n; ++i) {
+            slots_[(tail + i) & mask_] = items[i];
+        }
+        if (n) tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Consumer only. Pops up to `maxCount` items into `out`, returns how many.
+    size_t popBulk(T* out, size_t maxCount) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t avail = cachedTail_ - head;
+        if (avail < maxCount) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            avail = cachedTail_ - head;
+        }
+        const size_t n = maxCount < avail ? maxCount : avail;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = slots_[(head + i) & mask_];
+        }
+        if (n) head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    static size_t roundUpPow2(size_t v) {
+        size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    const size_t   mask_;
+    std::vector<T> slots_;
+
+    // Consumer-owned line
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t                          cachedTail_ = 0;
+
+    // Producer-owned line
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t                          cachedHead_ = 0;
+};
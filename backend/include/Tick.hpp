@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/// A single trade from the raw tick feed
+struct Tick {
+    int64_t timestamp;  // epoch milliseconds
+    double  price;
+    double  size;
+    int64_t recvUs = 0; // monotonicMicros() when read off the socket; not on the wire
+};
+
+/// Wire layout of one tick on the ingest socket: int64 timestamp, double price,
+/// double size, packed back to back in host byte order (little-endian on every
+/// platform we build for). No framing beyond the fixed record size.
+constexpr size_t kTickWireSize = sizeof(int64_t) + 2 * sizeof(double);
+
+inline void encodeTick(const Tick& t, unsigned char* out) {
+    std::memcpy(out,      &t.timestamp, sizeof(int64_t));
+    std::memcpy(out + 8,  &t.price,     sizeof(double));
+    std::memcpy(out + 16, &t.size,      sizeof(double));
+}
+
+inline Tick decodeTick(const unsigned char* in) {
+    Tick t{};
+    std::memcpy(&t.timestamp, in,      sizeof(int64_t));
+    std::memcpy(&t.price,     in + 8,  sizeof(double));
+    std::memcpy(&t.size,      in + 16, sizeof(double));
+    return t;
+}
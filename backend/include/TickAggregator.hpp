@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RenderEngine.hpp"
+#include "SpscRing.hpp"
+#include "Tick.hpp"
+
+/// Consumer side of the tick pipeline: drains the ingest ring on its own
+/// thread, folds ticks into fixed-interval OHLC bars and publishes them to
+/// SeriesStore under `seriesId`. The forming bar is re-published in place as
+/// it changes; a bar is final once a tick for a later interval arrives.
+class TickAggregator {
+public:
+    TickAggregator(SpscRing<Tick>& ring, std::string seriesId, int64_t intervalMs);
+    ~TickAggregator();
+
+    void start();
+    void stop();
+
+    uint64_t ticksProcessed() const { return ticksProcessed_.load(std::memory_order_relaxed); }
+    uint64_t ticksDropped()   const { return ticksDropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void apply(const Tick& t);
+    void flush();
+
+    SpscRing<Tick>&        ring_;
+    const std::string      seriesId_;
+    const int64_t          intervalMs_;
+
+    OhlcPoint              forming_{};
+    bool                   hasForming_ = false;
+    std::vector<OhlcPoint> pending_;   // closed bars + forming bar awaiting publish
+    bool                   dirty_ = false;
+    int64_t                pendingRecvUs_ = 0;  // earliest tick receipt since last publish
+
+    std::atomic<bool>      running_{false};
+    std::atomic<uint64_t>  ticksProcessed_{0};
+    std::atomic<uint64_t>  ticksDropped_{0};
+    std::thread            worker_;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "SpscRing.hpp"
+#include "Tick.hpp"
+
+/// Where the ingest listener binds. A non-empty `unixPath` wins over the TCP
+/// port; TCP always binds to loopback since the feed is a local process.
+struct TickIngestConfig {
+    std::string    unixPath;
+    unsigned short tcpPort = 0;
+};
+
+/// Producer side of the tick pipeline: accepts one feed connection at a time
+/// (the ring has a single producer), decodes fixed-size tick records and
+/// pushes them into the ring, blocking the feed when the ring is full.
+class TickIngestServer {
+public:
+    TickIngestServer(SpscRing<Tick>& ring, TickIngestConfig config);
+
+    /// Spawns a detached listener thread; the accept loop runs for the process
+    /// lifetime, so the server must outlive it
+    void start();
+
+    uint64_t ticksReceived() const { return ticksReceived_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    template <typename Socket>
+    void pump(Socket& socket);
+
+    SpscRing<Tick>&       ring_;
+    const TickIngestConfig config_;
+    std::atomic<uint64_t> ticksReceived_{0};
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/// Microseconds on the monotonic clock. All frame stage timestamps use this
+/// clock. On POSIX it is CLOCK_MONOTONIC, so stamps from processes on the
+/// same host (e.g. shared-memory readers) are comparable too.
+inline int64_t monotonicMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// Server-side stage timestamps carried on a traced frame (0 = unknown)
+struct FrameTrace {
+    int64_t ingestUs   = 0;  // earliest tick behind this frame was read off the ingest socket
+    int64_t genStartUs = 0;  // snapshot + generation started
+    int64_t genEndUs   = 0;  // generators returned, before serialization
+    int64_t enqueueUs  = 0;  // serialized and queued for the socket
+};
+
+struct LatencySummary {
+    uint64_t count = 0;
+    int64_t  p50   = 0;
+    int64_t  p90   = 0;
+    int64_t  p99   = 0;
+    int64_t  max   = 0;
+};
+
+/// Log-linear histogram of microsecond latencies: each power of two is split
+/// into 8 linear sub-buckets, so percentiles are within ~12% at any scale
+/// while the whole thing stays a fixed 4 KiB array. Not thread-safe.
+class LatencyHistogram {
+public:
+    void record(int64_t us);
+    LatencySummary summary() const;
+
+    static constexpr int kSubBits = 3;
+    static constexpr int kBuckets = 64 << kSubBits;
+
+    /// Bucket that counts `v`, and the largest value that bucket holds
+    static int     bucketFor(uint64_t v);
+    static int64_t upperBound(int bucket);
+
+private:
+    std::array<uint64_t, kBuckets> counts_{};
+    uint64_t                       total_ = 0;
+    int64_t                        max_   = 0;
+};
+
+/// Latency of one subscription, as reported by a stats request
+struct SubscriptionStats {
+    std::string    subscriptionId;
+    uint64_t       framesSent = 0;
+    uint64_t       framesAcked = 0;
+    LatencySummary pipeline;  // ingest -> write complete (server only)
+    LatencySummary rtt;       // write complete -> client ack
+    LatencySummary endToEnd;  // ingest -> client ack (tick to glass)
+};
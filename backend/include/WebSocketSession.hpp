@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <rapidjson/document.h>
+#include "DrawCommand.hpp"
+#include "RelayUpstream.hpp"
+#include "RenderEngine.hpp"
+#include "Tracing.hpp"
+
+/// One client connection. Each session owns a single-threaded io_context and
+/// runs it on its own thread, so reads, writes and server-pushed updates are
+/// serialized without locks; other threads hand work in via post().
+///
+/// A connection carries any number of subscriptions, each named by a
+/// client-chosen id that is echoed on every frame it produces. A subscribe
+/// without an id uses the empty id and gets untagged frames, as before.
+///
+/// Subscriptions may opt into "seq" (monotonic frame numbers) and "trace"
+/// (seq plus server stage timestamps). Traced clients return
+/// {type:"ack", id, seq} after drawing; the session turns write-complete and
+/// ack times into per-subscription latency histograms.
+///
+/// Live subscriptions with "patch" get a full drawCommands frame first and
+/// then, while the chart's normalization range holds, patchSeries frames that
+/// carry only the vertices of the bars that changed. Optional "from"/"to"
+/// (ms) limit a live subscription to a time window; {type:"viewport", id,
+/// from, to} moves it, e.g. on pan/zoom.
+///
+/// In relay mode, live subscriptions are fed by RelayUpstream instead of the
+/// local store; relayed frames get a new id/seq prefix and are sent as is.
+class WebSocketSession : public std::enable_shared_from_this<WebSocketSession> {
+public:
+    WebSocketSession();
+    ~WebSocketSession();
+
+    /// Accept the TCP connection into this socket before calling run()
+    boost::asio::ip::tcp::socket& socket();
+
+    /// Completes the handshake and serves the client until it disconnects
+    void run();
+
+private:
+    struct PendingAck {
+        uint64_t seq;
+        int64_t  ingestUs;
+        int64_t  writeDoneUs;
+    };
+
+    struct Subscription {
+        std::string              id;
+        std::vector<std::string> seriesTypes;
+        std::string              source;          // SeriesStore id; empty for the data file
+        uint64_t                 storeToken = 0;
+        unsigned                 queued = 0;      // frames for this subscription in the outbox
+        bool                     dirty = false;   // update arrived while a frame was queued
+        std::atomic<bool>        refreshPending{false};
+
+        bool                        patches = false;  // send patchSeries for live updates
+        std::vector<RenderedSeries> rendered;         // what the client holds, for patching
+        uint64_t                    renderedVersion = 0;  // store version behind `rendered`
+        int64_t                  fromT = INT64_MIN;  // live time window (viewport), inclusive
+        int64_t                  toT   = INT64_MAX;
+        uint64_t                 relayToken = 0;     // relay mode: RelayUpstream listener
+        bool                     relayStale = false; // dropped relayed frames; needs a full one
+        uint64_t                 relayGeneration = 0;
+
+        bool                     sequenced = false;
+        bool                     traced    = false;
+        uint64_t                 nextSeq   = 1;
+        std::deque<PendingAck>   awaitingAck;     // written, not yet acked (bounded)
+        uint64_t                 framesSent  = 0;
+        uint64_t                 framesAcked = 0;
+        LatencyHistogram         pipeline;        // ingest -> write complete
+        LatencyHistogram         rtt;             // write complete -> ack
+        LatencyHistogram         endToEnd;        // ingest -> ack
+    };
+    using SubscriptionPtr = std::shared_ptr<Subscription>;
+
+    struct Outgoing {
+        std::string     frame;
+        SubscriptionPtr sub;   // null for replies not tied to a subscription
+        uint64_t        seq      = 0;
+        int64_t         ingestUs = 0;
+    };
+
+    void doRead();
+    void onRead(boost::beast::error_code ec, std::size_t bytes);
+    void handleMessage(const std::string& msg);
+    void handleSubscribe(const rapidjson::Document& req);
+    void handleUnsubscribe(const rapidjson::Document& req);
+    void handleViewport(const rapidjson::Document& req);
+    void handleThumbnails(const rapidjson::Document& req);
+    void handleAck(const rapidjson::Document& req);
+    void handleStats(const rapidjson::Document& req);
+
+    /// Queue a text frame; frames are written one at a time in order
+    void send(std::string frame, SubscriptionPtr sub = nullptr, uint64_t seq = 0, int64_t ingestUs = 0);
+    /// Serialize, number and (if traced) stamp a drawCommands frame, then send it
+    void sendDrawCommands(const SubscriptionPtr& sub, const std::vector<ChartingApp::DrawCommand>& cmds,
+                          FrameTrace trace);
+    /// Same for a patchSeries frame
+    void sendPatches(const SubscriptionPtr& sub, const std::vector<ChartingApp::SeriesPatch>& patches,
+                     FrameTrace trace);
+    /// Stamps enqueue and appends the trace to an already numbered frame if the
+    /// subscription is traced, then sends it; callers stamp genStart/genEnd
+    void sendTraced(const SubscriptionPtr& sub, std::string frame, uint64_t seq, FrameTrace trace);
+    void doWrite();
+    void onWrite(boost::beast::error_code ec, std::size_t bytes);
+
+    void removeSubscription(const std::string& id);
+    void clearSubscriptions();
+    static void recordWrite(Subscription& sub, uint64_t seq, int64_t ingestUs);
+    static void logLatency(const Subscription& sub);
+    static SubscriptionStats statsFor(const Subscription& sub);
+
+    // Live series from SeriesStore
+    void scheduleRefresh(const SubscriptionPtr& sub);
+    void refreshLive(const SubscriptionPtr& sub);
+
+    // Live series relayed from an upstream chart_server
+    void attachRelay(const SubscriptionPtr& sub);
+    void relayFrame(const SubscriptionPtr& sub, const RelayFramePtr& frame);
+
+    boost::asio::io_context                                   ioc_{1};
+    boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws_;
+    boost::beast::flat_buffer                                 readBuf_;
+    std::deque<Outgoing>                                      outbox_;
+
+    std::unordered_map<std::string, SubscriptionPtr>          subscriptions_;
+    bool                                                      thumbnailsPending_ = false;  // one batch at a time
+};
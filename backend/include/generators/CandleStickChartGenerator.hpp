@@ -11,4 +11,9 @@ class CandleStickChartGenerator : public ChartSeriesGenerator {
 public:
     DrawCommand generate(const std::string& seriesId, const std::vector<OhlcPoint>& data) override;
     DrawCommand generate(const std::string& seriesId, const std::vector<DataPoint>& data) override;
+    SeriesBounds boundsFor(const std::vector<OhlcPoint>& data) override;
+    bool normalizes() const override { return true; }
+    DrawCommand generateTail(const std::string& seriesId, const std::vector<OhlcPoint>& data,
+                             const SeriesBounds& bounds, size_t fromIndex) override;
+    size_t floatsPerBar() const override { return 12; }  // wick + top edge + bottom edge
 };
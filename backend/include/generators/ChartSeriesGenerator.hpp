@@ -28,4 +28,28 @@ public:
         const std::string& seriesId,
         const std::vector<OhlcPoint>& data
     ) = 0;
+
+    /// Range `data` is normalized against; generators emitting raw values
+    /// keep the default, so their vertices never go stale
+    virtual SeriesBounds boundsFor(const std::vector<OhlcPoint>& data) {
+        (void)data;
+        return {};
+    }
+
+    /// True if boundsFor() is the time/low/high range of the bars, so a
+    /// range already known to the caller (e.g. SeriesStore's index) can be
+    /// passed to generateTail() instead of scanning the data again
+    virtual bool normalizes() const { return false; }
+
+    /// Vertices of data[fromIndex..] only, normalized against `bounds`. They
+    /// match generate()'s output from float offset fromIndex * floatsPerBar().
+    virtual DrawCommand generateTail(
+        const std::string& seriesId,
+        const std::vector<OhlcPoint>& data,
+        const SeriesBounds& bounds,
+        size_t fromIndex
+    ) = 0;
+
+    /// Vertex floats emitted per bar
+    virtual size_t floatsPerBar() const = 0;
 };
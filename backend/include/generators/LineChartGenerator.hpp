@@ -12,4 +12,7 @@ public:
         const std::string& seriesId,
         const std::vector<DataPoint>& data
     ) override;
+    DrawCommand generateTail(const std::string& seriesId, const std::vector<OhlcPoint>& data,
+                             const SeriesBounds& bounds, size_t fromIndex) override;
+    size_t floatsPerBar() const override { return 2; }
 };
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "thumbnails/ThumbnailRasterizer.hpp"
+
+/// Minimal self-contained PNG writer (no zlib dependency).
+///
+/// Images with at most 256 distinct colors, which covers every thumbnail we
+/// rasterize, are written as 8-bit indexed PNG with a tRNS chunk; anything
+/// else falls back to 8-bit RGBA. Pixel data is compressed with fixed-Huffman
+/// deflate and a greedy LZ77 matcher, which is plenty for flat-color charts.
+class PngEncoder {
+public:
+    static std::vector<uint8_t> encode(const RgbaImage& image);
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "thumbnails/ThumbnailRasterizer.hpp"
+
+struct ThumbnailRequest {
+    std::string      source;      // SeriesStore id
+    std::string      seriesType;  // generator to render with ("line", "candlestick")
+    ThumbnailOptions options;
+};
+
+struct Thumbnail {
+    std::string                                 source;
+    uint64_t                                    version = 0;  // SeriesStore version it was rendered from
+    std::shared_ptr<const std::vector<uint8_t>> png;          // null on error
+    std::string                                 error;
+};
+
+/// PNG thumbnails of SeriesStore series, cached per (series, type, size) and
+/// invalidated by the series version, so unchanged symbols cost a map lookup.
+///
+/// The cache is an LRU bounded by entry count and PNG bytes, since the key
+/// includes the client-chosen size. Misses are rendered on one worker pool
+/// shared by all sessions, sized to the hardware, so concurrent requests
+/// queue up instead of each spawning its own threads. The queue is bounded
+/// too: misses that do not fit come back as errors.
+class ThumbnailCache {
+public:
+    using Done = std::function<void(std::vector<Thumbnail>)>;
+
+    static ThumbnailCache& instance();
+    ~ThumbnailCache();
+
+    /// One result per request, in order, handed to `done`. Hits are resolved
+    /// immediately; with misses, `done` runs on a pool thread once the last
+    /// one is rendered, so callers must hand the result off (e.g. post it).
+    /// If the pool's queue is full, the misses fail with an error instead.
+    void render(std::vector<ThumbnailRequest> requests, Done done);
+
+    uint64_t hits()      const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses()    const { return misses_.load(std::memory_order_relaxed); }
+    uint64_t evictions() const { return evictions_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint64_t                                    version = 0;
+        std::shared_ptr<const std::vector<uint8_t>> png;
+        std::list<std::string>::iterator            lru;    // position in lru_
+    };
+    struct Batch;
+
+    ThumbnailCache() = default;
+
+    static std::string keyFor(const ThumbnailRequest& req);
+    static Thumbnail   renderOne(const ThumbnailRequest& req);
+
+    void store(const std::string& key, const Thumbnail& t);
+    void evict();
+
+    /// Queues all of `tasks`, or none if that would overflow the queue
+    bool enqueue(std::vector<std::function<void()>> tasks);
+    void workerLoop();
+
+    std::mutex                             mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string>                 lru_;           // most recently used first
+    size_t                                 bytes_ = 0;     // PNG bytes held by entries_
+    std::atomic<uint64_t>                  hits_{0};
+    std::atomic<uint64_t>                  misses_{0};
+    std::atomic<uint64_t>                  evictions_{0};
+
+    std::mutex                             poolMutex_;
+    std::condition_variable                poolWake_;
+    std::deque<std::function<void()>>      tasks_;
+    std::vector<std::thread>               workers_;       // started on first miss
+    bool                                   stopping_ = false;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DrawCommand.hpp"
+
+using ChartingApp::DrawCommand;
+
+/// 8-bit RGBA pixels, row-major, top row first
+struct RgbaImage {
+    int                  width  = 0;
+    int                  height = 0;
+    std::vector<uint8_t> pixels;  // width * height * 4
+};
+
+struct ThumbnailOptions {
+    int      width      = 120;
+    int      height     = 40;
+    int      padding    = 1;           // px kept clear on every edge
+    uint32_t background = 0x00000000;  // 0xRRGGBBAA; transparent by default
+};
+
+/// Software rasterizer for DrawCommands, used for server-side thumbnails.
+/// Mirrors the WebGL renderers: "line" series are drawn as a line strip in
+/// `style.color`, "candlestick" series as independent segments in
+/// `style.wickColor` (falling back to `style.color`). Vertices are fitted to
+/// the image by their bounding box, so raw and normalized series both work.
+class ThumbnailRasterizer {
+public:
+    static RgbaImage rasterize(
+        const std::string& seriesType,
+        const std::vector<DrawCommand>& commands,
+        const ThumbnailOptions& options
+    );
+};
@@ -0,0 +1,117 @@
+// BinaryFrame.cpp
+
+#include "BinaryFrame.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using ChartingApp::DrawCommand;
+
+namespace {
+template <typename T>
+void put(std::vector<uint8_t>& out, T v) {
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &v, sizeof(T));
+}
+
+void putString(std::vector<uint8_t>& out, const std::string& s) {
+    const size_t n = std::min<size_t>(s.size(), std::numeric_limits<uint16_t>::max());
+    put<uint16_t>(out, uint16_t(n));
+    out.insert(out.end(), s.begin(), s.begin() + n);
+}
+
+class Cursor {
+public:
+    Cursor(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    bool get(T& v) {
+        if (size_ - pos_ < sizeof(T)) return false;
+        std::memcpy(&v, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string& s) {
+        uint16_t n = 0;
+        if (!get(n) || size_ - pos_ < n) return false;
+        s.assign(reinterpret_cast<const char*>(data_ + pos_), n);
+        pos_ += n;
+        return true;
+    }
+
+    bool getFloats(std::vector<float>& v, uint32_t n) {
+        pos_ = (pos_ + 3) & ~size_t(3);
+        if (pos_ > size_ || (size_ - pos_) / sizeof(float) < n) return false;
+        v.resize(n);
+        std::memcpy(v.data(), data_ + pos_, size_t(n) * sizeof(float));
+        pos_ += size_t(n) * sizeof(float);
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t         size_;
+    size_t         pos_ = 0;
+};
+} // namespace
+
+void encodeBinaryFrame(const BinaryFrame& frame, std::vector<uint8_t>& out) {
+    size_t vertexBytes = 0;
+    for (const auto& c : frame.commands) vertexBytes += c.vertices.size() * sizeof(float) + 64;
+    out.clear();
+    out.reserve(64 + frame.source.size() + vertexBytes);
+
+    put<uint32_t>(out, kBinaryFrameMagic);
+    put<uint32_t>(out, uint32_t(frame.commands.size()));
+    put<uint64_t>(out, frame.version);
+    put<int64_t>(out, frame.ingestUs);
+    put<int64_t>(out, frame.genEndUs);
+    putString(out, frame.source);
+
+    for (const auto& c : frame.commands) {
+        putString(out, c.type);
+        putString(out, c.label);
+        putString(out, c.pane);
+        putString(out, c.seriesId);
+        putString(out, c.style.type);
+        putString(out, c.style.color);
+        putString(out, c.style.altColor);
+        putString(out, c.style.wickColor);
+        put<float>(out, c.style.thickness);
+        put<uint32_t>(out, uint32_t(c.vertices.size()));
+        out.resize((out.size() + 3) & ~size_t(3), 0);
+        const size_t at = out.size();
+        out.resize(at + c.vertices.size() * sizeof(float));
+        if (!c.vertices.empty()) {
+            std::memcpy(out.data() + at, c.vertices.data(), c.vertices.size() * sizeof(float));
+        }
+    }
+}
+
+bool decodeBinaryFrame(const uint8_t* data, size_t size, BinaryFrame& out) {
+    Cursor in(data, size);
+    uint32_t magic = 0, count = 0;
+    if (!in.get(magic) || magic != kBinaryFrameMagic) return false;
+    if (!in.get(count) || !in.get(out.version) || !in.get(out.ingestUs) ||
+        !in.get(out.genEndUs) || !in.getString(out.source)) {
+        return false;
+    }
+
+    out.commands.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        DrawCommand c;
+        uint32_t n = 0;
+        if (!in.getString(c.type) || !in.getString(c.label) || !in.getString(c.pane) ||
+            !in.getString(c.seriesId) || !in.getString(c.style.type) ||
+            !in.getString(c.style.color) ||
+            !in.getString(c.style.altColor) || !in.getString(c.style.wickColor) ||
+            !in.get(c.style.thickness) || !in.get(n) || !in.getFloats(c.vertices, n)) {
+            return false;
+        }
+        out.commands.push_back(std::move(c));
+    }
+    return true;
+}
@@ -0,0 +1,360 @@
+// PngEncoderTest.cpp
+// PngEncoder output decoded back to RGBA by an independent reader (inflate,
+// CRC, Adler-32, palette/tRNS) must equal the input, in both color modes
+
+#include "thumbnails/PngEncoder.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+// ─── Inflate (RFC 1951): stored, fixed and dynamic Huffman blocks ────────
+
+class Inflater {
+public:
+    Inflater(const uint8_t* data, size_t size) : in_(data), size_(size) {}
+
+    bool run(std::vector<uint8_t>& out) {
+        bool last = false;
+        while (!last) {
+            last = bits(1);
+            const int type = bits(2);
+            bool ok = false;
+            if (type == 0)      ok = stored(out);
+            else if (type == 1) ok = fixed(out);
+            else if (type == 2) ok = dynamic(out);
+            if (!ok || bad_) return false;
+        }
+        return true;
+    }
+
+    /// Bytes consumed, rounded up to a whole byte
+    size_t consumed() const { return pos_ + (bit_ ? 1 : 0); }
+
+private:
+    struct Huffman {
+        std::vector<int> counts = std::vector<int>(16, 0);
+        std::vector<int> symbols;
+    };
+
+    int bits(int n) {
+        int v = 0;
+        for (int i = 0; i < n; ++i) {
+            if (pos_ >= size_) { bad_ = true; return 0; }
+            v |= ((in_[pos_] >> bit_) & 1) << i;
+            if (++bit_ == 8) { bit_ = 0; ++pos_; }
+        }
+        return v;
+    }
+
+    static Huffman build(const std::vector<int>& lengths) {
+        Huffman h;
+        for (int len : lengths) ++h.counts[len];
+        h.counts[0] = 0;
+        std::vector<int> offs(16, 0);
+        for (int len = 1; len < 16; ++len) offs[len] = offs[len - 1] + h.counts[len - 1];
+        h.symbols.resize(lengths.size());
+        for (size_t s = 0; s < lengths.size(); ++s) {
+            if (lengths[s]) h.symbols[offs[lengths[s]]++] = int(s);
+        }
+        return h;
+    }
+
+    // Canonical codes are read MSB first, one bit at a time
+    int decode(const Huffman& h) {
+        int code = 0, first = 0, index = 0;
+        for (int len = 1; len < 16; ++len) {
+            code |= bits(1);
+            const int count = h.counts[len];
+            if (code - first < count) return h.symbols[index + code - first];
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        bad_ = true;
+        return -1;
+    }
+
+    bool stored(std::vector<uint8_t>& out) {
+        if (bit_) { bit_ = 0; ++pos_; }
+        if (pos_ + 4 > size_) return false;
+        const unsigned len  = in_[pos_] | (in_[pos_ + 1] << 8);
+        const unsigned nlen = in_[pos_ + 2] | (in_[pos_ + 3] << 8);
+        pos_ += 4;
+        if ((len ^ 0xFFFFu) != nlen || pos_ + len > size_) return false;
+        out.insert(out.end(), in_ + pos_, in_ + pos_ + len);
+        pos_ += len;
+        return true;
+    }
+
+    bool codes(std::vector<uint8_t>& out, const Huffman& litLen, const Huffman& dist) {
+        static const int kLenBase[]  = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const int kLenExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const int kDistBase[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                        193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+                                        4097, 6145, 8193, 12289, 16385, 24577};
+        static const int kDistExtra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                         7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        for (;;) {
+            int sym = decode(litLen);
+            if (bad_ || sym < 0) return false;
+            if (sym < 256) { out.push_back(uint8_t(sym)); continue; }
+            if (sym == 256) return true;
+            sym -= 257;
+            if (sym >= 29) return false;
+            const int len = kLenBase[sym] + bits(kLenExtra[sym]);
+            const int d = decode(dist);
+            if (bad_ || d < 0 || d >= 30) return false;
+            const size_t distance = size_t(kDistBase[d] + bits(kDistExtra[d]));
+            if (distance > out.size()) return false;
+            for (int i = 0; i < len; ++i) out.push_back(out[out.size() - distance]);
+        }
+    }
+
+    bool fixed(std::vector<uint8_t>& out) {
+        std::vector<int> lengths(288);
+        for (int s = 0; s < 288; ++s) lengths[s] = s < 144 ? 8 : s < 256 ? 9 : s < 280 ? 7 : 8;
+        return codes(out, build(lengths), build(std::vector<int>(30, 5)));
+    }
+
+    bool dynamic(std::vector<uint8_t>& out) {
+        static const int kOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        const int nlen = bits(5) + 257, ndist = bits(5) + 1, ncode = bits(4) + 4;
+        std::vector<int> codeLengths(19, 0);
+        for (int i = 0; i < ncode; ++i) codeLengths[kOrder[i]] = bits(3);
+        const Huffman lencode = build(codeLengths);
+
+        std::vector<int> lengths;
+        while (int(lengths.size()) < nlen + ndist) {
+            const int sym = decode(lencode);
+            if (bad_ || sym < 0) return false;
+            if (sym < 16) { lengths.push_back(sym); continue; }
+            int repeat = 0, value = 0;
+            if (sym == 16) {
+                if (lengths.empty()) return false;
+                value  = lengths.back();
+                repeat = 3 + bits(2);
+            } else if (sym == 17) {
+                repeat = 3 + bits(3);
+            } else {
+                repeat = 11 + bits(7);
+            }
+            lengths.insert(lengths.end(), repeat, value);
+        }
+        if (int(lengths.size()) != nlen + ndist) return false;
+        return codes(out, build({lengths.begin(), lengths.begin() + nlen}),
+                     build({lengths.begin() + nlen, lengths.end()}));
+    }
+
+    const uint8_t* in_;
+    size_t         size_;
+    size_t         pos_ = 0;
+    int            bit_ = 0;
+    bool           bad_ = false;
+};
+
+// ─── PNG reader ──────────────────────────────────────────────────────────
+
+uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+uint32_t adler32(const std::vector<uint8_t>& data) {
+    uint32_t a = 1, b = 0;
+    for (uint8_t v : data) {
+        a = (a + v) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t be32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+int paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+struct Decoded {
+    bool       ok = false;
+    int        colorType = -1;
+    RgbaImage  image;
+};
+
+// Accepts 8-bit palette (3) and RGBA (6), non-interlaced: what the encoder
+// may write. Everything else counts as a failure.
+Decoded decodePng(const std::vector<uint8_t>& png) {
+    Decoded d;
+    static const uint8_t kSig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (png.size() < 8 || !std::equal(kSig, kSig + 8, png.begin())) return d;
+
+    std::vector<uint8_t> idat, palette, alpha;
+    int width = 0, height = 0;
+    bool seenEnd = false;
+    for (size_t pos = 8; pos < png.size();) {
+        if (pos + 12 > png.size()) return d;
+        const uint32_t len = be32(&png[pos]);
+        if (pos + 12 + len > png.size()) return d;
+        const std::string type(png.begin() + long(pos) + 4, png.begin() + long(pos) + 8);
+        const uint8_t* body = &png[pos + 8];
+        if (crc32(&png[pos + 4], len + 4) != be32(body + len)) return d;
+
+        if (type == "IHDR") {
+            if (len != 13 || body[8] != 8 || body[10] || body[11] || body[12]) return d;
+            width  = int(be32(body));
+            height = int(be32(body + 4));
+            d.colorType = body[9];
+        } else if (type == "PLTE") {
+            palette.assign(body, body + len);
+        } else if (type == "tRNS") {
+            alpha.assign(body, body + len);
+        } else if (type == "IDAT") {
+            idat.insert(idat.end(), body, body + len);
+        } else if (type == "IEND") {
+            seenEnd = pos + 12 == png.size();
+        }
+        pos += 12 + len;
+    }
+    if (!seenEnd || width <= 0 || height <= 0) return d;
+    if (d.colorType != 3 && d.colorType != 6) return d;
+    if (d.colorType == 3 && (palette.empty() || palette.size() % 3 || alpha.size() > palette.size() / 3)) return d;
+
+    // zlib: CMF/FLG check, deflate data, Adler-32 of the inflated bytes
+    if (idat.size() < 6 || (idat[0] & 0x0F) != 8 || ((idat[0] << 8) | idat[1]) % 31 || (idat[1] & 0x20)) return d;
+    std::vector<uint8_t> raw;
+    Inflater inflater(idat.data() + 2, idat.size() - 2);
+    if (!inflater.run(raw)) return d;
+    const size_t end = 2 + inflater.consumed();
+    if (end + 4 != idat.size() || be32(&idat[end]) != adler32(raw)) return d;
+
+    const size_t bpp = d.colorType == 3 ? 1 : 4;
+    const size_t stride = size_t(width) * bpp;
+    if (raw.size() != size_t(height) * (stride + 1)) return d;
+
+    std::vector<uint8_t> prev(stride, 0), row(stride);
+    d.image.width  = width;
+    d.image.height = height;
+    d.image.pixels.reserve(size_t(width) * height * 4);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* line = &raw[size_t(y) * (stride + 1)];
+        const int filter = line[0];
+        for (size_t x = 0; x < stride; ++x) {
+            const int a = x >= bpp ? row[x - bpp] : 0, b = prev[x], c = x >= bpp ? prev[x - bpp] : 0;
+            int pred = 0;
+            switch (filter) {
+                case 0: pred = 0; break;
+                case 1: pred = a; break;
+                case 2: pred = b; break;
+                case 3: pred = (a + b) / 2; break;
+                case 4: pred = paeth(a, b, c); break;
+                default: return d;
+            }
+            row[x] = uint8_t(line[1 + x] + pred);
+        }
+        for (int x = 0; x < width; ++x) {
+            if (d.colorType == 6) {
+                d.image.pixels.insert(d.image.pixels.end(), &row[size_t(x) * 4], &row[size_t(x) * 4] + 4);
+                continue;
+            }
+            const size_t i = row[x];
+            if (i * 3 + 2 >= palette.size()) return d;
+            d.image.pixels.push_back(palette[i * 3]);
+            d.image.pixels.push_back(palette[i * 3 + 1]);
+            d.image.pixels.push_back(palette[i * 3 + 2]);
+            d.image.pixels.push_back(i < alpha.size() ? alpha[i] : 255);
+        }
+        prev.swap(row);
+    }
+    d.ok = true;
+    return d;
+}
+
+// ─── Cases ───────────────────────────────────────────────────────────────
+
+RgbaImage blank(int w, int h) {
+    RgbaImage img;
+    img.width  = w;
+    img.height = h;
+    img.pixels.assign(size_t(w) * h * 4, 0);
+    return img;
+}
+
+void setPixel(RgbaImage& img, int x, int y, uint32_t rgba) {
+    uint8_t* p = &img.pixels[(size_t(y) * img.width + x) * 4];
+    p[0] = uint8_t(rgba >> 24);
+    p[1] = uint8_t(rgba >> 16);
+    p[2] = uint8_t(rgba >> 8);
+    p[3] = uint8_t(rgba);
+}
+
+void checkRoundTrip(const RgbaImage& img, int colorType) {
+    const Decoded d = decodePng(PngEncoder::encode(img));
+    CHECK(d.ok);
+    CHECK(d.colorType == colorType);
+    CHECK(d.image.width == img.width && d.image.height == img.height);
+    CHECK(d.image.pixels == img.pixels);
+}
+
+void testIndexed() {
+    // A sparkline: transparent background, a line, long flat runs
+    RgbaImage spark = blank(120, 40);
+    for (int x = 0; x < 120; ++x) {
+        const int y = 20 + int(15 * std::sin(x / 9.0));
+        setPixel(spark, x, y, 0x00FF00FF);
+        setPixel(spark, x, 39, x % 2 ? 0xFF000080 : 0x888888FF);
+    }
+    checkRoundTrip(spark, 3);
+
+    // Opaque only (no tRNS chunk), 1x1, and tall enough for matches past
+    // the 258-byte maximum length and at long distances
+    RgbaImage opaque = blank(1, 1);
+    setPixel(opaque, 0, 0, 0x123456FF);
+    checkRoundTrip(opaque, 3);
+
+    RgbaImage big = blank(700, 300);
+    std::mt19937 rng(9);
+    for (int y = 0; y < 300; ++y)
+        for (int x = 0; x < 700; ++x)
+            setPixel(big, x, y, (y / 50) % 2 ? 0xFFFFFFFF : uint32_t(rng() % 16) << 8 | 0xFF);
+    checkRoundTrip(big, 3);
+
+    // Exactly 256 colors still fit a palette
+    RgbaImage full = blank(16, 16);
+    for (int i = 0; i < 256; ++i) setPixel(full, i % 16, i / 16, uint32_t(i) << 16 | 0xFF);
+    checkRoundTrip(full, 3);
+}
+
+void testRgba() {
+    // 257 colors: one past the palette limit
+    RgbaImage over = blank(257, 1);
+    for (int i = 0; i < 257; ++i) setPixel(over, i, 0, uint32_t(i) << 8 | 0x7F);
+    checkRoundTrip(over, 6);
+
+    RgbaImage noise = blank(64, 48);
+    std::mt19937 rng(17);
+    for (auto& v : noise.pixels) v = uint8_t(rng());
+    checkRoundTrip(noise, 6);
+}
+}  // namespace
+
+int main() {
+    testIndexed();
+    testRgba();
+    return testResult("png_encoder_test");
+}
@@ -10,6 +10,32 @@
 
 #include <string>
 
+namespace {
+std::string base64Encode(const std::vector<uint8_t>& in) {
+    static const char* kAlphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((in.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < in.size(); i += 3) {
+        uint32_t v = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) | in[i + 2];
+        out += kAlphabet[(v >> 18) & 63];
+        out += kAlphabet[(v >> 12) & 63];
+        out += kAlphabet[(v >> 6) & 63];
+        out += kAlphabet[v & 63];
+    }
+    if (i < in.size()) {
+        uint32_t v = uint32_t(in[i]) << 16;
+        if (i + 1 < in.size()) v |= uint32_t(in[i + 1]) << 8;
+        out += kAlphabet[(v >> 18) & 63];
+        out += kAlphabet[(v >> 12) & 63];
+        out += i + 1 < in.size() ? kAlphabet[(v >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+} // namespace
+
 std::string Protocol::processRequest(
     const std::string& chartType,
     const std::string& jsonArrayStr
@@ -33,9 +59,26 @@ std::string Protocol::processRequest(
     // If empty and no commands, decide if it's an error or simply no data.
     // For simplicity, treat empty commands as valid (no data) rather than an error.
     // Construct the batch envelope:
+    return serializeDrawCommands(commands);
+}
+
+std::string Protocol::serializeDrawCommands(
+    const std::vector<ChartingApp::DrawCommand>& commands,
+    const std::string& subscriptionId,
+    uint64_t seq
+) {
+    using namespace rapidjson;
 
     Document resp(kObjectType);
     auto& alloc = resp.GetAllocator();
+    if (!subscriptionId.empty()) {
+        resp.AddMember("subscriptionId",
+                       Value(subscriptionId.c_str(), alloc),
+                       alloc);
+    }
+    if (seq != 0) {
+        resp.AddMember("seq", seq, alloc);
+    }
     resp.AddMember("type", "drawCommands", alloc);
 
     Value arr(kArrayType);
@@ -62,6 +105,9 @@ std::string Protocol::processRequest(
         obj.AddMember("vertices", verts, alloc);
         // Style
         Value styleObj(kObjectType);
+        styleObj.AddMember("type",
+                           Value(cmd.style.type.c_str(), alloc),
+                           alloc);
         styleObj.AddMember("color",
                            Value(cmd.style.color.c_str(), alloc),
                            alloc);
@@ -85,3 +131,236 @@ std::string Protocol::processRequest(
     resp.Accept(writer);
     return buf.GetString();
 }
+
+std::string Protocol::serializePatches(
+    const std::vector<ChartingApp::SeriesPatch>& patches,
+    const std::string& subscriptionId,
+    uint64_t seq
+) {
+    using namespace rapidjson;
+
+    Document resp(kObjectType);
+    auto& alloc = resp.GetAllocator();
+    if (!subscriptionId.empty()) {
+        resp.AddMember("subscriptionId",
+                       Value(subscriptionId.c_str(), alloc),
+                       alloc);
+    }
+    if (seq != 0) {
+        resp.AddMember("seq", seq, alloc);
+    }
+    resp.AddMember("type", "patchSeries", alloc);
+
+    Value arr(kArrayType);
+    for (const auto& p : patches) {
+        Value obj(kObjectType);
+        obj.AddMember("index", uint64_t(p.index), alloc);
+        obj.AddMember("seriesId",
+                      Value(p.seriesId.c_str(), alloc),
+                      alloc);
+        obj.AddMember("offset", uint64_t(p.offset), alloc);
+        Value verts(kArrayType);
+        for (float v : p.vertices) {
+            verts.PushBack(v, alloc);
+        }
+        obj.AddMember("vertices", verts, alloc);
+        arr.PushBack(obj, alloc);
+    }
+    resp.AddMember("patches", arr, alloc);
+
+    StringBuffer buf;
+    Writer<StringBuffer> writer(buf);
+    resp.Accept(writer);
+    return buf.GetString();
+}
+
+std::string Protocol::serializeError(
+    const std::string& message,
+    const std::string& subscriptionId
+) {
+    using namespace rapidjson;
+
+    StringBuffer buf;
+    Writer<StringBuffer> writer(buf);
+    writer.StartObject();
+    if (!subscriptionId.empty()) {
+        writer.Key("subscriptionId");
+        writer.String(subscriptionId.c_str());
+    }
+    writer.Key("type");
+    writer.String("error");
+    writer.Key("message");
+    writer.String(message.c_str());
+    writer.EndObject();
+    return buf.GetString();
+}
+
+std::string Protocol::serializeUnsubscribed(const std::string& subscriptionId) {
+    using namespace rapidjson;
+
+    StringBuffer buf;
+    Writer<StringBuffer> writer(buf);
+    writer.StartObject();
+    writer.Key("subscriptionId");
+    writer.String(subscriptionId.c_str());
+    writer.Key("type");
+    writer.String("unsubscribed");
+    writer.EndObject();
+    return buf.GetString();
+}
+
+std::string Protocol::serializeThumbnails(
+    const std::vector<Thumbnail>& thumbnails,
+    const std::string& subscriptionId
+) {
+    using namespace rapidjson;
+
+    StringBuffer buf;
+    Writer<StringBuffer> writer(buf);
+    writer.StartObject();
+    if (!subscriptionId.empty()) {
+        writer.Key("subscriptionId");
+        writer.String(subscriptionId.c_str());
+    }
+    writer.Key("type");
+    writer.String("thumbnails");
+    writer.Key("images");
+    writer.StartArray();
+    for (const auto& t : thumbnails) {
+        writer.StartObject();
+        writer.Key("source");
+        writer.String(t.source.c_str());
+        if (t.png) {
+            writer.Key("version");
+            writer.Uint64(t.version);
+            writer.Key("png");
+            std::string b64 = base64Encode(*t.png);
+            writer.String(b64.c_str(), static_cast<SizeType>(b64.size()));
+        } else {
+            writer.Key("error");
+            writer.String(t.error.c_str());
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return buf.GetString();
+}
+
+bool Protocol::splitEnvelope(
+    const std::string& frame,
+    std::string& subscriptionId,
+    uint64_t& seq,
+    size_t& bodyPos
+) {
+    static const std::string kIdPrefix  = "{\"subscriptionId\":\"";
+    static const std::string kSeqPrefix = ",\"seq\":";
+
+    if (frame.compare(0, kIdPrefix.size(), kIdPrefix) != 0) return false;
+    size_t pos = kIdPrefix.size();
+    const size_t idEnd = frame.find('"', pos);
+    if (idEnd == std::string::npos) return false;
+    if (frame.find('\\', pos) < idEnd) return false;
+    subscriptionId.assign(frame, pos, idEnd - pos);
+    pos = idEnd + 1;
+
+    seq = 0;
+    if (frame.compare(pos, kSeqPrefix.size(), kSeqPrefix) == 0) {
+        pos += kSeqPrefix.size();
+        const size_t digits = pos;
+        while (pos < frame.size() && frame[pos] >= '0' && frame[pos] <= '9') {
+            seq = seq * 10 + uint64_t(frame[pos] - '0');
+            ++pos;
+        }
+        if (pos == digits) return false;
+    }
+
+    if (pos >= frame.size() || frame[pos] != ',') return false;
+    bodyPos = pos + 1;
+    return true;
+}
+
+std::string Protocol::wrapBody(
+    const std::string& body,
+    const std::string& subscriptionId,
+    uint64_t seq
+) {
+    std::string out;
+    out.reserve(body.size() + subscriptionId.size() + 48);
+    out += '{';
+    if (!subscriptionId.empty()) {
+        rapidjson::StringBuffer id;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(id);
+        writer.String(subscriptionId.c_str());
+        out += "\"subscriptionId\":";
+        out += id.GetString();
+        out += ',';
+    }
+    if (seq != 0) {
+        out += "\"seq\":";
+        out += std::to_string(seq);
+        out += ',';
+    }
+    out += body;
+    return out;
+}
+
+void Protocol::appendTrace(std::string& frame, const FrameTrace& trace) {
+    if (frame.empty() || frame.back() != '}') return;
+    frame.pop_back();
+    frame += ",\"trace\":{\"ingest\":";
+    frame += std::to_string(trace.ingestUs);
+    frame += ",\"genStart\":";
+    frame += std::to_string(trace.genStartUs);
+    frame += ",\"genEnd\":";
+    frame += std::to_string(trace.genEndUs);
+    frame += ",\"enqueue\":";
+    frame += std::to_string(trace.enqueueUs);
+    frame += "}}";
+}
+
+std::string Protocol::serializeStats(
+    const std::vector<SubscriptionStats>& stats,
+    const std::string& subscriptionId
+) {
+    using namespace rapidjson;
+
+    StringBuffer buf;
+    Writer<StringBuffer> writer(buf);
+    auto summary = [&writer](const char* key, const LatencySummary& s) {
+        writer.Key(key);
+        writer.StartObject();
+        writer.Key("count"); writer.Uint64(s.count);
+        writer.Key("p50");   writer.Int64(s.p50);
+        writer.Key("p90");   writer.Int64(s.p90);
+        writer.Key("p99");   writer.Int64(s.p99);
+        writer.Key("max");   writer.Int64(s.max);
+        writer.EndObject();
+    };
+
+    writer.StartObject();
+    if (!subscriptionId.empty()) {
+        writer.Key("subscriptionId");
+        writer.String(subscriptionId.c_str());
+    }
+    writer.Key("type");
+    writer.String("stats");
+    writer.Key("subscriptions");
+    writer.StartArray();
+    for (const auto& st : stats) {
+        writer.StartObject();
+        writer.Key("subscriptionId");
+        writer.String(st.subscriptionId.c_str());
+        writer.Key("framesSent");
+        writer.Uint64(st.framesSent);
+        writer.Key("framesAcked");
+        writer.Uint64(st.framesAcked);
+        summary("pipeline", st.pipeline);
+        summary("rtt",      st.rtt);
+        summary("endToEnd", st.endToEnd);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return buf.GetString();
+}
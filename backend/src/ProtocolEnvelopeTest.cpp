@@ -0,0 +1,96 @@
+// ProtocolEnvelopeTest.cpp
+// Relay re-tagging: splitEnvelope must find the id, seq and body of what our
+// serializers emit, and wrapBody must put them back byte for byte
+
+#include "Protocol.hpp"
+#include "TestSupport.hpp"
+
+#include <cstdint>
+#include <limits>
+
+using ChartingApp::DrawCommand;
+using ChartingApp::SeriesPatch;
+
+namespace {
+struct Split {
+    bool        ok = false;
+    std::string id;
+    uint64_t    seq = 0;
+    std::string body;
+};
+
+Split split(const std::string& frame) {
+    Split s;
+    size_t bodyPos = 0;
+    s.ok = Protocol::splitEnvelope(frame, s.id, s.seq, bodyPos);
+    if (s.ok) s.body = frame.substr(bodyPos);
+    return s;
+}
+
+// A serialized frame splits into its id and seq, and re-wrapping the body
+// with them (or with another id, as the relay does) gives a well-formed frame
+void checkFrame(const std::string& frame, const std::string& id, uint64_t seq) {
+    Split s = split(frame);
+    CHECK(s.ok);
+    CHECK(s.id == id);
+    CHECK(s.seq == seq);
+    CHECK(s.body.compare(0, 7, "\"type\":") == 0);
+    CHECK(Protocol::wrapBody(s.body, s.id, s.seq) == frame);
+
+    Split relayed = split(Protocol::wrapBody(s.body, "local-7", 99));
+    CHECK(relayed.ok);
+    CHECK(relayed.id == "local-7");
+    CHECK(relayed.seq == 99);
+    CHECK(relayed.body == s.body);
+}
+
+void testSerializers() {
+    DrawCommand cmd;
+    cmd.type     = "drawSeries";
+    cmd.label    = "line";
+    cmd.pane     = "main";
+    cmd.seriesId = "BTC-USD";
+    cmd.vertices = {0.f, 1.f, 0.5f, -1.f};
+    cmd.style    = {"line", "#00ff00", "#ff0000", "#888888", 1.5f};
+    checkFrame(Protocol::serializeDrawCommands({cmd}, "r12", 1), "r12", 1);
+    checkFrame(Protocol::serializeDrawCommands({cmd}, "r12", 0), "r12", 0);
+
+    SeriesPatch patch{0, "BTC-USD", 8, {0.25f, 0.75f}};
+    checkFrame(Protocol::serializePatches({patch}, "r12", 42), "r12", 42);
+    checkFrame(Protocol::serializePatches({patch}, "r12", std::numeric_limits<uint64_t>::max()),
+               "r12", std::numeric_limits<uint64_t>::max());
+
+    checkFrame(Protocol::serializeError("subscription limit reached", "r3"), "r3", 0);
+}
+
+void testWrapBody() {
+    const std::string body = "\"type\":\"patchSeries\",\"patches\":[]}";
+    CHECK(Protocol::wrapBody(body) == "{" + body);
+    CHECK(Protocol::wrapBody(body, "a", 3) == "{\"subscriptionId\":\"a\",\"seq\":3," + body);
+    CHECK(Protocol::wrapBody(body, "a") == "{\"subscriptionId\":\"a\"," + body);
+
+    Split s = split(Protocol::wrapBody(body, "sub 1", 12345678901234ull));
+    CHECK(s.ok && s.id == "sub 1" && s.seq == 12345678901234ull && s.body == body);
+}
+
+// Frames splitEnvelope refuses; the relay drops them rather than misroute
+void testRejected() {
+    const std::string body = "\"type\":\"stats\"}";
+    CHECK(!split("{" + body).ok);                                           // no id
+    CHECK(!split(Protocol::wrapBody(body, "", 5)).ok);                      // seq, no id
+    CHECK(!split(Protocol::wrapBody(body, "a\"b", 1)).ok);                  // escaped id
+    CHECK(!split(Protocol::wrapBody(body, "a\\b", 1)).ok);
+    CHECK(!split("{\"subscriptionId\":\"a\",\"seq\":,\"type\":1}").ok);     // seq without digits
+    CHECK(!split("{\"subscriptionId\":\"a\",\"seq\":1x,\"type\":1}").ok);   // trailing garbage
+    CHECK(!split("{\"subscriptionId\":\"a\"}").ok);                         // nothing after the id
+    CHECK(!split("{\"subscriptionId\":\"a").ok);                            // unterminated
+    CHECK(!split("").ok);
+}
+}  // namespace
+
+int main() {
+    testSerializers();
+    testWrapBody();
+    testRejected();
+    return testResult("protocol_envelope_test");
+}
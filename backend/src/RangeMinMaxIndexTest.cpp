@@ -0,0 +1,150 @@
+// RangeMinMaxIndexTest.cpp
+// RangeMinMaxIndex and the SeriesStore windows built on it must agree with a
+// plain scan of the bars, through appends, capacity growth and forming-bar updates
+
+#include "RangeMinMaxIndex.hpp"
+#include "SeriesStore.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+struct Bar {
+    double low;
+    double high;
+};
+
+void scan(const std::vector<Bar>& bars, size_t first, size_t last, double& low, double& high) {
+    low  = bars[first].low;
+    high = bars[first].high;
+    for (size_t i = first + 1; i <= last; ++i) {
+        low  = std::min(low,  bars[i].low);
+        high = std::max(high, bars[i].high);
+    }
+}
+
+// Every window of a short series, then random ones as it grows past
+// several capacity doublings (64, 128, ...) with the last bar re-set in place
+void testIndex() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> step(-1.0, 1.0), spread(0.0, 2.0);
+    RangeMinMaxIndex index;
+    std::vector<Bar> bars;
+    double price = 100.0;
+
+    auto checkWindow = [&](size_t first, size_t last) {
+        double low, high, wantLow, wantHigh;
+        index.query(first, last, low, high);
+        scan(bars, first, last, wantLow, wantHigh);
+        CHECK(low == wantLow);
+        CHECK(high == wantHigh);
+    };
+
+    for (int i = 0; i < 1000; ++i) {
+        price += step(rng);
+        Bar bar{price - spread(rng), price + spread(rng)};
+        if (!bars.empty() && rng() % 3 == 0) {
+            bars.back() = bar;  // the forming bar moved
+            index.set(bars.size() - 1, bar.low, bar.high);
+        } else {
+            bars.push_back(bar);
+            index.push(bar.low, bar.high);
+        }
+        CHECK(index.size() == bars.size());
+
+        const size_t n = bars.size();
+        if (n <= 20) {
+            for (size_t first = 0; first < n; ++first)
+                for (size_t last = first; last < n; ++last) checkWindow(first, last);
+        } else {
+            for (int q = 0; q < 20; ++q) {
+                size_t a = rng() % n, b = rng() % n;
+                checkWindow(std::min(a, b), std::max(a, b));
+            }
+            checkWindow(0, n - 1);
+            checkWindow(n - 1, n - 1);
+        }
+    }
+
+    index.clear();
+    CHECK(index.size() == 0);
+    index.push(1.0, 2.0);
+    double low, high;
+    index.query(0, 0, low, high);
+    CHECK(low == 1.0 && high == 2.0);
+}
+
+// The store maps time windows to bar indices; its bars and bounds must match
+// a scan of the whole series
+void testStoreWindows() {
+    const std::string id = "range_min_max_index_test";
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> step(-1.0, 1.0), spread(0.0, 2.0);
+    double price = 50.0;
+    int64_t t = 1000;
+
+    for (int i = 0; i < 400; ++i) {
+        if (rng() % 3 != 0) t += 60;  // otherwise update the forming bar
+        price += step(rng);
+        OhlcPoint bar{t, price, price + spread(rng), price - spread(rng), price};
+        SeriesStore::instance().publishBars(id, {bar});
+
+        for (int q = 0; q < 5; ++q) {
+            int64_t a = 900 + static_cast<int64_t>(rng() % static_cast<uint64_t>(t - 800));
+            int64_t b = 900 + static_cast<int64_t>(rng() % static_cast<uint64_t>(t - 800));
+            int64_t t0 = std::min(a, b), t1 = std::max(a, b);
+
+            std::vector<OhlcPoint> want;
+            for (const auto& w : SeriesStore::instance().snapshot(id))
+                if (w.timestamp >= t0 && w.timestamp <= t1) want.push_back(w);
+
+            SeriesBounds bounds;
+            auto window = SeriesStore::instance().snapshotRange(id, t0, t1, &bounds);
+            SeriesBounds range;
+            bool found = SeriesStore::instance().priceRange(id, t0, t1, range);
+            CHECK(window.size() == want.size());
+            CHECK(found == !want.empty());
+            if (want.empty() || window.size() != want.size()) continue;
+            CHECK(window.front().timestamp == want.front().timestamp);
+
+            SeriesBounds wantBounds{want.front().timestamp, want.back().timestamp,
+                                    want.front().low, want.front().high};
+            for (const auto& w : want) {
+                wantBounds.minP = std::min(wantBounds.minP, w.low);
+                wantBounds.maxP = std::max(wantBounds.maxP, w.high);
+            }
+            CHECK(bounds == wantBounds);
+            CHECK(range == wantBounds);
+        }
+
+        // The trailing window the shm publisher sends
+        const auto all = SeriesStore::instance().snapshot(id);
+        const size_t maxBars = 1 + rng() % 80;
+        SeriesBounds tailBounds;
+        auto tail = SeriesStore::instance().snapshotLast(id, maxBars, &tailBounds);
+        const size_t n = std::min(maxBars, all.size());
+        CHECK(tail.size() == n);
+        if (tail.size() == n) {
+            CHECK(tail.front().timestamp == all[all.size() - n].timestamp);
+            SeriesBounds want{tail.front().timestamp, tail.back().timestamp, tail.front().low, tail.front().high};
+            for (const auto& w : tail) {
+                want.minP = std::min(want.minP, w.low);
+                want.maxP = std::max(want.maxP, w.high);
+            }
+            CHECK(tailBounds == want);
+        }
+        CHECK(SeriesStore::instance().snapshotLast(id, 0, nullptr).size() == all.size());
+    }
+
+    SeriesBounds none;
+    CHECK(!SeriesStore::instance().priceRange(id, 0, 999, none));
+    CHECK(!SeriesStore::instance().priceRange("unknown", INT64_MIN, INT64_MAX, none));
+}
+}  // namespace
+
+int main() {
+    testIndex();
+    testStoreWindows();
+    return testResult("range_min_max_index_test");
+}
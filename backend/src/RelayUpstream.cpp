@@ -0,0 +1,451 @@
+// RelayUpstream.cpp
+// Client side of relay mode: multiplexed connections to an upstream chart_server
+
+#include "RelayUpstream.hpp"
+#include "Protocol.hpp"
+
+#include <chrono>
+#include <iostream>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+namespace beast     = boost::beast;
+namespace websocket = beast::websocket;
+namespace net       = boost::asio;
+using     tcp       = net::ip::tcp;
+
+namespace {
+// Patches cached per channel for late joiners; past this they are folded
+// into the cached full frame
+constexpr size_t kMaxCachedPatches = 1024;
+
+// The origin's per-connection subscription cap (kMaxSubscriptions in
+// WebSocketSession.cpp); a link never asks for more
+constexpr size_t kChannelsPerLink = 256;
+
+// Bounds upstream connections, and so the distinct channels (sources x
+// series types x windows) one relay serves
+constexpr size_t kMaxLinks = 4;
+
+constexpr auto kConnectTimeout = std::chrono::seconds(5);
+constexpr auto kReconnectDelay = std::chrono::seconds(1);
+
+bool startsWith(const std::string& s, const char* prefix) {
+    return s.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+// Body of an error frame without an envelope, in the form handleFrame yields
+RelayFramePtr errorFrame(const std::string& message) {
+    auto f = std::make_shared<RelayFrame>();
+    f->body = Protocol::serializeError(message).substr(1);
+    return f;
+}
+
+// Applies patchSeries bodies to a drawCommands body, giving the body of the
+// equivalent full frame. Only the cached copy is rewritten; viewers already
+// hold this state, so nothing is re-sent.
+bool foldPatches(const RelayFrame& full, const std::vector<RelayFramePtr>& patches, std::string& out) {
+    using namespace rapidjson;
+
+    Document doc;
+    const std::string json = "{" + full.body;
+    doc.Parse(json.c_str());
+    if (doc.HasParseError() || !doc.IsObject() ||
+        !doc.HasMember("commands") || !doc["commands"].IsArray()) {
+        return false;
+    }
+    Value& commands = doc["commands"];
+    auto&  alloc    = doc.GetAllocator();
+
+    for (const auto& p : patches) {
+        Document pd;
+        const std::string pj = "{" + p->body;
+        pd.Parse(pj.c_str());
+        if (pd.HasParseError() || !pd.IsObject() ||
+            !pd.HasMember("patches") || !pd["patches"].IsArray()) {
+            return false;
+        }
+        for (const auto& patch : pd["patches"].GetArray()) {
+            if (!patch.HasMember("index")    || !patch["index"].IsUint()  ||
+                !patch.HasMember("offset")   || !patch["offset"].IsUint() ||
+                !patch.HasMember("vertices") || !patch["vertices"].IsArray()) {
+                return false;
+            }
+            const unsigned index = patch["index"].GetUint();
+            if (index >= commands.Size() || !commands[index].HasMember("vertices") ||
+                !commands[index]["vertices"].IsArray()) {
+                return false;
+            }
+            Value&   verts  = commands[index]["vertices"];
+            unsigned offset = patch["offset"].GetUint();
+            if (offset > verts.Size()) return false;  // would leave a hole
+            for (const auto& v : patch["vertices"].GetArray()) {
+                if (offset < verts.Size()) {
+                    verts[offset].CopyFrom(v, alloc);
+                }
+                else {
+                    Value copy(v, alloc);
+                    verts.PushBack(copy, alloc);
+                }
+                ++offset;
+            }
+        }
+    }
+
+    StringBuffer buf;
+    Writer<StringBuffer> writer(buf);
+    doc.Accept(writer);
+    out.assign(buf.GetString() + 1, buf.GetSize() - 1);  // drop the '{' again
+    return true;
+}
+} // namespace
+
+std::string RelayChannelKey::str() const {
+    // Every string is length-prefixed, so no choice of source or type names
+    // can make two different requests spell the same key
+    auto field = [](std::string& k, const std::string& s) {
+        k += std::to_string(s.size());
+        k += ':';
+        k += s;
+    };
+    std::string k;
+    field(k, source);
+    k += std::to_string(seriesTypes.size());
+    k += '[';
+    for (const auto& t : seriesTypes) field(k, t);
+    k += patch ? "]p" : "]-";
+    k += std::to_string(fromT);
+    k += ':';
+    k += std::to_string(toT);
+    return k;
+}
+
+RelayUpstream& RelayUpstream::instance() {
+    static RelayUpstream relay;
+    return relay;
+}
+
+void RelayUpstream::start(const std::string& host, unsigned short port) {
+    if (running_.exchange(true)) return;
+    host_ = host;
+    port_ = port;
+    net::post(ioc_, [this] { linkWithRoom(); });
+    // Runs for the process lifetime, like the ingest listener
+    std::thread([this] { ioc_.run(); }).detach();
+    std::cout << "[Relay] Serving live subscriptions from " << host_ << ":" << port_ << "\n";
+}
+
+// ─── Channels ────────────────────────────────────────────────────────────
+
+uint64_t RelayUpstream::attach(const RelayChannelKey& key, Listener listener) {
+    const uint64_t token = nextToken_++;
+    net::post(ioc_, [this, token, key, listener = std::move(listener)] {
+        const std::string k = key.str();
+        auto it = byKey_.find(k);
+        if (it == byKey_.end()) {
+            Link* link = linkWithRoom();
+            if (!link) {
+                listener(errorFrame("Too many relay channels"));
+                return;
+            }
+
+            // First viewer of this channel: subscribe upstream once
+            Channel ch;
+            ch.upstreamId = "r" + std::to_string(nextChannel_++);
+            ch.link       = link;
+
+            rapidjson::StringBuffer buf;
+            rapidjson::Writer<rapidjson::StringBuffer> w(buf);
+            w.StartObject();
+            w.Key("type");   w.String("subscribe");
+            w.Key("id");     w.String(ch.upstreamId.c_str());
+            w.Key("source"); w.String(key.source.c_str());
+            w.Key("seriesTypes");
+            w.StartArray();
+            for (const auto& t : key.seriesTypes) w.String(t.c_str());
+            w.EndArray();
+            w.Key("seq");    w.Bool(true);
+            w.Key("patch");  w.Bool(key.patch);
+            if (key.fromT != INT64_MIN) { w.Key("from"); w.Int64(key.fromT); }
+            if (key.toT   != INT64_MAX) { w.Key("to");   w.Int64(key.toT); }
+            w.EndObject();
+            ch.subscribeMsg = buf.GetString();
+
+            ++link->channels;
+            if (link->connected) sendUpstream(*link, ch.subscribeMsg);
+            it = byKey_.emplace(k, ch.upstreamId).first;
+            channels_.emplace(ch.upstreamId, std::move(ch));
+        }
+        Channel& ch = channels_[it->second];
+        deliverCache(ch, listener);
+        ch.listeners.emplace(token, listener);
+        byToken_[token] = ch.upstreamId;
+    });
+    return token;
+}
+
+void RelayUpstream::detach(uint64_t token) {
+    net::post(ioc_, [this, token] {
+        auto t = byToken_.find(token);
+        if (t == byToken_.end()) return;
+        auto c = channels_.find(t->second);
+        byToken_.erase(t);
+        if (c == channels_.end()) return;
+
+        Channel& ch = c->second;
+        ch.listeners.erase(token);
+        if (!ch.listeners.empty()) return;
+
+        // Last viewer gone: release the upstream subscription
+        if (ch.link->connected) {
+            sendUpstream(*ch.link, "{\"type\":\"unsubscribe\",\"id\":\"" + ch.upstreamId + "\"}");
+        }
+        closeChannel(ch.upstreamId);
+    });
+}
+
+void RelayUpstream::replay(uint64_t token) {
+    net::post(ioc_, [this, token] {
+        auto t = byToken_.find(token);
+        if (t == byToken_.end()) return;
+        auto c = channels_.find(t->second);
+        if (c == channels_.end()) return;
+        auto l = c->second.listeners.find(token);
+        if (l != c->second.listeners.end()) deliverCache(c->second, l->second);
+    });
+}
+
+// Forgets a channel locally; its listeners' tokens become no-ops
+void RelayUpstream::closeChannel(const std::string& upstreamId) {
+    auto c = channels_.find(upstreamId);
+    if (c == channels_.end()) return;
+    for (const auto& [token, listener] : c->second.listeners) byToken_.erase(token);
+    for (auto k = byKey_.begin(); k != byKey_.end(); ++k) {
+        if (k->second == upstreamId) {
+            byKey_.erase(k);
+            break;
+        }
+    }
+    --c->second.link->channels;
+    channels_.erase(c);
+}
+
+void RelayUpstream::deliverCache(const Channel& ch, const Listener& listener) {
+    // Without a complete cache a joiner waits for the next full frame
+    if (!ch.full || !ch.cacheComplete) return;
+    listener(ch.full);
+    for (const auto& p : ch.patches) listener(p);
+}
+
+void RelayUpstream::requestResync(Channel& ch) {
+    if (ch.resyncPending || !ch.link->connected) return;
+    // Re-subscribing under the same id makes upstream start over with a full frame
+    ch.resyncPending = true;
+    sendUpstream(*ch.link, ch.subscribeMsg);
+}
+
+void RelayUpstream::compact(Channel& ch) {
+    auto folded  = std::make_shared<RelayFrame>();
+    folded->kind = RelayFrame::Kind::Full;
+    if (ch.full && foldPatches(*ch.full, ch.patches, folded->body)) {
+        ch.full = std::move(folded);
+        ch.patches.clear();
+        return;
+    }
+    // Keep relaying, but late joiners need a fresh base from upstream
+    ch.cacheComplete = false;
+    ch.patches.clear();
+    requestResync(ch);
+}
+
+void RelayUpstream::handleFrame(const std::string& frame) {
+    std::string id;
+    uint64_t    seq = 0;
+    size_t      bodyPos = 0;
+    if (!Protocol::splitEnvelope(frame, id, seq, bodyPos)) return;
+    auto it = channels_.find(id);
+    if (it == channels_.end()) return;  // late frame for a released channel
+    Channel& ch = it->second;
+
+    auto f = std::make_shared<RelayFrame>();
+    f->body = frame.substr(bodyPos);
+    if (startsWith(f->body, "\"type\":\"drawCommands\"")) {
+        f->kind = RelayFrame::Kind::Full;
+    } else if (startsWith(f->body, "\"type\":\"patchSeries\"")) {
+        f->kind = RelayFrame::Kind::Patch;
+    } else if (startsWith(f->body, "\"type\":\"unsubscribed\"")) {
+        return;
+    } else if (startsWith(f->body, "\"type\":\"error\"")) {
+        // The subscribe was refused: nothing will ever arrive on this channel
+        std::cerr << "[Relay] Upstream refused channel " << id << ": " << f->body << "\n";
+        if (f->body.find("Too many subscriptions") != std::string::npos && ch.link->channels > 0) {
+            // The origin allows fewer per connection than we assumed
+            ch.link->capacity = ch.link->channels - 1;
+        }
+        for (const auto& [token, listener] : ch.listeners) listener(f);
+        closeChannel(id);
+        return;
+    }
+
+    if (f->kind != RelayFrame::Kind::Other) {
+        const bool gap = seq != 0 && ch.lastSeq != 0 && seq != ch.lastSeq + 1;
+        ch.lastSeq = seq;
+
+        if (f->kind == RelayFrame::Kind::Full) {
+            ch.full = f;
+            ch.patches.clear();
+            ch.cacheComplete = true;
+            ch.synced        = true;
+            ch.resyncPending = false;
+        } else {
+            if (gap) ch.synced = false;
+            if (!ch.synced) {
+                // Does not apply to what local viewers hold; wait for a full frame
+                requestResync(ch);
+                return;
+            }
+            if (ch.cacheComplete) {
+                ch.patches.push_back(f);
+                if (ch.patches.size() >= kMaxCachedPatches) compact(ch);
+            }
+        }
+    }
+
+    for (const auto& [token, listener] : ch.listeners) listener(f);
+}
+
+// ─── Connections ─────────────────────────────────────────────────────────
+
+RelayUpstream::Link* RelayUpstream::linkWithRoom() {
+    for (auto& link : links_) {
+        if (link->channels < link->capacity) return link.get();
+    }
+    if (links_.size() == kMaxLinks) return nullptr;
+    links_.push_back(std::make_unique<Link>(ioc_, links_.size(), kChannelsPerLink));
+    Link& link = *links_.back();
+    connect(link);
+    return &link;
+}
+
+void RelayUpstream::connect(Link& link) {
+    const uint64_t gen = ++link.generation;
+    auto ws = std::make_shared<Stream>(ioc_);
+    link.ws      = ws;
+    link.readBuf = std::make_shared<beast::flat_buffer>();
+
+    // One deadline over resolve, connect and handshake; the relay thread
+    // never blocks, so attach/detach keep flowing while upstream is down
+    link.timer.expires_after(kConnectTimeout);
+    link.timer.async_wait([this, &link, gen](beast::error_code ec) {
+        if (!ec && gen == link.generation) connectFailed(link, "timed out");
+    });
+
+    link.resolver.async_resolve(host_, std::to_string(port_),
+        [this, &link, ws, gen](beast::error_code ec, tcp::resolver::results_type results) {
+            if (gen != link.generation) return;
+            if (ec) return connectFailed(link, ec.message());
+            net::async_connect(ws->next_layer(), results,
+                [this, &link, ws, gen](beast::error_code ec, const tcp::endpoint&) {
+                    if (gen != link.generation) return;
+                    if (ec) return connectFailed(link, ec.message());
+                    ws->set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
+                    ws->async_handshake(host_ + ":" + std::to_string(port_), "/",
+                        [this, &link, gen](beast::error_code ec) {
+                            if (gen != link.generation) return;
+                            if (ec) return connectFailed(link, ec.message());
+                            onConnected(link);
+                        });
+                });
+        });
+}
+
+void RelayUpstream::connectFailed(Link& link, const std::string& why) {
+    if (link.failures++ == 0) {
+        std::cerr << "[Relay] Link " << link.index << " cannot reach upstream " << host_ << ":"
+                  << port_ << ": " << why << " (retrying)\n";
+    }
+    ++link.generation;  // whatever is still pending of this attempt is stale
+    link.resolver.cancel();
+    beast::error_code ignored;
+    link.ws->next_layer().close(ignored);
+    scheduleReconnect(link);
+}
+
+void RelayUpstream::onConnected(Link& link) {
+    link.timer.cancel();
+    link.ws->text(true);
+    std::cout << "[Relay] Link " << link.index << " connected to upstream " << host_ << ":"
+              << port_ << "\n";
+    link.connected = true;
+    link.failures  = 0;
+
+    // Upstream sequence numbers restart with the new connection, and its
+    // first frame per channel is a full one
+    for (auto& [id, ch] : channels_) {
+        if (ch.link != &link) continue;
+        ch.synced        = false;
+        ch.resyncPending = true;
+        ch.lastSeq       = 0;
+        sendUpstream(link, ch.subscribeMsg);
+    }
+    doRead(link);
+}
+
+void RelayUpstream::scheduleReconnect(Link& link) {
+    link.timer.expires_after(kReconnectDelay);
+    link.timer.async_wait([this, &link](beast::error_code ec) {
+        if (!ec) connect(link);
+    });
+}
+
+void RelayUpstream::onDisconnect(Link& link, const std::string& why) {
+    if (!link.connected) return;
+    std::cerr << "[Relay] Link " << link.index << " lost upstream: " << why << "\n";
+    link.connected = false;
+    // A write still in flight owns its message, and its completion is stale
+    // after this, so the queue can go right away
+    ++link.generation;
+    link.writing = false;
+    link.outbox.clear();
+    beast::error_code ignored;
+    link.ws->next_layer().close(ignored);
+    // Local viewers keep the cached state until upstream is back
+    scheduleReconnect(link);
+}
+
+void RelayUpstream::doRead(Link& link) {
+    const uint64_t gen = link.generation;
+    auto ws  = link.ws;
+    auto buf = link.readBuf;
+    ws->async_read(*buf, [this, &link, ws, buf, gen](beast::error_code ec, std::size_t) {
+        if (gen != link.generation) return;
+        if (ec) return onDisconnect(link, ec.message());
+        std::string frame = beast::buffers_to_string(buf->data());
+        buf->consume(buf->size());
+        handleFrame(frame);
+        doRead(link);
+    });
+}
+
+void RelayUpstream::sendUpstream(Link& link, std::string msg) {
+    link.outbox.push_back(std::move(msg));
+    if (link.connected && !link.writing) doWrite(link);
+}
+
+void RelayUpstream::doWrite(Link& link) {
+    const uint64_t gen = link.generation;
+    auto ws  = link.ws;
+    auto msg = std::make_shared<std::string>(std::move(link.outbox.front()));
+    link.outbox.pop_front();
+    link.writing = true;
+    ws->async_write(net::buffer(*msg), [this, &link, ws, msg, gen](beast::error_code ec, std::size_t) {
+        if (gen != link.generation) return;
+        link.writing = false;
+        if (ec) return onDisconnect(link, ec.message());
+        if (!link.outbox.empty()) doWrite(link);
+    });
+}
@@ -157,3 +157,112 @@ std::vector<DrawCommand> RenderEngine::generateIncrementalDrawCommands(
     DrawCommand cmd = gen->generate(seriesType, sliceData);
     return { std::move(cmd) };
 }
+
+// Generation from bars already in memory (live series)
+std::vector<DrawCommand> RenderEngine::generateBarDrawCommands(
+    const std::string& seriesType,
+    const std::string& seriesId,
+    const std::vector<OhlcPoint>& bars
+) {
+    if (bars.empty()) {
+        return {};
+    }
+    auto gen = ChartGeneratorFactory::create(seriesType);
+    if (!gen) {
+        std::cerr << "[RenderEngine] No generator registered for '" << seriesType << "'" << std::endl;
+        return {};
+    }
+    DrawCommand cmd = gen->generate(seriesId, bars);
+    return { std::move(cmd) };
+}
+
+std::vector<DrawCommand> RenderEngine::renderLiveBars(
+    const std::vector<std::string>& seriesTypes,
+    const std::string& seriesId,
+    const std::vector<OhlcPoint>& bars,
+    std::vector<RenderedSeries>& rendered,
+    const SeriesBounds* knownBounds
+) {
+    std::vector<DrawCommand> cmds;
+    rendered.clear();
+    if (bars.empty()) {
+        return cmds;
+    }
+    for (const auto& st : seriesTypes) {
+        auto gen = ChartGeneratorFactory::create(st);
+        if (!gen) {
+            std::cerr << "[RenderEngine] No generator registered for '" << st << "'" << std::endl;
+            continue;
+        }
+        RenderedSeries r;
+        r.seriesType = st;
+        r.bounds     = knownBounds && gen->normalizes() ? *knownBounds : gen->boundsFor(bars);
+        r.barCount   = bars.size();
+        DrawCommand cmd = gen->generateTail(seriesId, bars, r.bounds, 0);
+        const size_t n = std::min(gen->floatsPerBar(), cmd.vertices.size());
+        r.lastBar.assign(cmd.vertices.end() - n, cmd.vertices.end());
+        rendered.push_back(std::move(r));
+        cmds.push_back(std::move(cmd));
+    }
+    return cmds;
+}
+
+bool RenderEngine::patchLiveBars(
+    const std::vector<std::string>& seriesTypes,
+    const std::string& seriesId,
+    const std::vector<OhlcPoint>& bars,
+    std::vector<RenderedSeries>& rendered,
+    std::vector<ChartingApp::SeriesPatch>& patches,
+    const SeriesBounds* knownBounds
+) {
+    patches.clear();
+    if (rendered.empty() || rendered.size() != seriesTypes.size() || bars.empty()) {
+        return false;
+    }
+
+    std::vector<RenderedSeries> next(rendered.size());
+    for (size_t i = 0; i < rendered.size(); ++i) {
+        const RenderedSeries& prev = rendered[i];
+        if (prev.seriesType != seriesTypes[i] || prev.barCount == 0 || bars.size() < prev.barCount) {
+            return false;
+        }
+        // Only the last bar sent can have changed in place; anything after it is new
+        const size_t from = prev.barCount - 1;
+        if (bars.size() - from > bars.size() / 2 + 1) {
+            return false;  // a patch would be about as big as the full frame
+        }
+
+        auto gen = ChartGeneratorFactory::create(prev.seriesType);
+        if (!gen) return false;
+        const SeriesBounds bounds = knownBounds && gen->normalizes() ? *knownBounds : gen->boundsFor(bars);
+        if (bounds != prev.bounds) {
+            return false;  // every vertex moves
+        }
+
+        const std::vector<float> tail = gen->generateTail(seriesId, bars, bounds, from).vertices;
+        const size_t fpb = gen->floatsPerBar();
+
+        // Trim floats the client already has: a tick that only moves the close
+        // touches a couple of body vertices, not the whole bar
+        size_t lo = 0, hi = tail.size();
+        const size_t common = std::min(prev.lastBar.size(), tail.size());
+        while (lo < common && tail[lo] == prev.lastBar[lo]) ++lo;
+        if (bars.size() == prev.barCount) {
+            while (hi > lo && tail[hi - 1] == prev.lastBar[hi - 1]) --hi;
+        }
+        if (lo < hi) {
+            patches.push_back(ChartingApp::SeriesPatch{
+                i, seriesId, from * fpb + lo,
+                std::vector<float>(tail.begin() + lo, tail.begin() + hi)});
+        }
+
+        next[i].seriesType = prev.seriesType;
+        next[i].bounds     = bounds;
+        next[i].barCount   = bars.size();
+        const size_t n = std::min(fpb, tail.size());
+        next[i].lastBar.assign(tail.end() - n, tail.end());
+    }
+
+    rendered.swap(next);
+    return true;
+}
@@ -0,0 +1,144 @@
+// RenderEngineTest.cpp
+// Live patches: a client applying patchLiveBars output must hold exactly the
+// vertices a full renderLiveBars of the same bars produces
+
+#include "RenderEngine.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <random>
+
+using ChartingApp::SeriesPatch;
+
+namespace {
+using Vertices = std::vector<std::vector<float>>;  // per command
+
+Vertices verticesOf(const std::vector<DrawCommand>& cmds) {
+    Vertices out;
+    for (const auto& c : cmds) out.push_back(c.vertices);
+    return out;
+}
+
+// What ChartSubscriber does with a patchSeries frame
+bool applyPatches(Vertices& client, const std::vector<SeriesPatch>& patches) {
+    for (const auto& p : patches) {
+        if (p.index >= client.size() || p.offset > client[p.index].size()) return false;
+        auto& v = client[p.index];
+        if (p.offset + p.vertices.size() > v.size()) v.resize(p.offset + p.vertices.size());
+        std::copy(p.vertices.begin(), p.vertices.end(), v.begin() + p.offset);
+    }
+    return true;
+}
+
+SeriesBounds boundsOf(const std::vector<OhlcPoint>& bars) {
+    SeriesBounds b{bars.front().timestamp, bars.back().timestamp, bars.front().low, bars.front().high};
+    for (const auto& bar : bars) {
+        b.minP = std::min(b.minP, bar.low);
+        b.maxP = std::max(b.maxP, bar.high);
+    }
+    return b;
+}
+
+struct Counts {
+    unsigned patched = 0;
+    unsigned full    = 0;
+    size_t   floats  = 0;  // patch floats sent
+};
+
+// Random walk of ticks on the forming bar, new highs/lows and new bars; after
+// every step the patched client must match a fresh full render exactly
+Counts run(const std::vector<std::string>& types, bool knownBounds, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> step(-0.4, 0.4);
+    std::uniform_int_distribution<int>     event(0, 99);
+
+    std::vector<OhlcPoint> bars;
+    double price = 100.0;
+    for (int i = 0; i < 200; ++i) {
+        const double o = price, c = price + step(rng);
+        bars.push_back(OhlcPoint{int64_t(i) * 60000, o, std::max(o, c) + 0.5, std::min(o, c) - 0.5, c});
+        price = c;
+    }
+
+    std::vector<RenderedSeries> rendered;
+    SeriesBounds bounds = boundsOf(bars);
+    Vertices client = verticesOf(
+        RenderEngine::renderLiveBars(types, "s", bars, rendered, knownBounds ? &bounds : nullptr));
+
+    Counts counts;
+    for (int n = 0; n < 3000; ++n) {
+        const int e = event(rng);
+        OhlcPoint& last = bars.back();
+        if (e < 85) {
+            // Tick inside the bar's range: only the close moves
+            last.close = last.low + (last.high - last.low) * (0.05 + 0.9 * (e / 85.0));
+        } else if (e < 95) {
+            // Tick that extends the bar, maybe past the series range
+            last.close = last.close + step(rng) * 4;
+            last.high  = std::max(last.high, last.close);
+            last.low   = std::min(last.low, last.close);
+        } else {
+            bars.push_back(OhlcPoint{last.timestamp + 60000, last.close, last.close, last.close, last.close});
+        }
+
+        bounds = boundsOf(bars);
+        std::vector<SeriesPatch> patches;
+        if (RenderEngine::patchLiveBars(types, "s", bars, rendered, patches,
+                                        knownBounds ? &bounds : nullptr)) {
+            CHECK(applyPatches(client, patches));
+            for (const auto& p : patches) counts.floats += p.vertices.size();
+            ++counts.patched;
+        } else {
+            client = verticesOf(
+                RenderEngine::renderLiveBars(types, "s", bars, rendered, knownBounds ? &bounds : nullptr));
+            ++counts.full;
+        }
+
+        std::vector<RenderedSeries> scratch;
+        const Vertices expected = verticesOf(RenderEngine::renderLiveBars(types, "s", bars, scratch));
+        CHECK(client == expected);
+        if (client != expected) break;
+    }
+    return counts;
+}
+} // namespace
+
+int main() {
+    const std::vector<std::vector<std::string>> typeSets = {
+        {"line"}, {"candlestick"}, {"line", "candlestick"}};
+    for (const auto& types : typeSets) {
+        for (bool known : {false, true}) {
+            const Counts c = run(types, known, 42);
+            // Most ticks only move the close, so most updates must be patches
+            // of a few floats rather than full frames
+            CHECK(c.patched > c.full);
+            CHECK(c.patched == 0 || c.floats / c.patched <= 16);
+        }
+    }
+
+    std::vector<OhlcPoint> bars = {
+        {0, 10, 12, 9, 11}, {60000, 11, 13, 10, 12}, {120000, 12, 13, 11, 12.5}};
+    std::vector<RenderedSeries> rendered;
+
+    // Each command names its layout, so clients know strips from segments
+    const auto cmds = RenderEngine::renderLiveBars({"line", "candlestick"}, "s", bars, rendered);
+    CHECK(cmds.size() == 2);
+    CHECK(cmds.size() == 2 && cmds[0].style.type == "line" && cmds[1].style.type == "candlestick");
+
+    // A close-only move on the forming candle re-sends just its changed floats
+    RenderEngine::renderLiveBars({"candlestick"}, "s", bars, rendered);
+    bars.back().close = 11.5;
+    std::vector<SeriesPatch> patches;
+    CHECK(RenderEngine::patchLiveBars({"candlestick"}, "s", bars, rendered, patches));
+    CHECK(patches.size() == 1 && patches[0].vertices.size() < 12);
+
+    // Nothing changed: a patch with nothing in it
+    CHECK(RenderEngine::patchLiveBars({"candlestick"}, "s", bars, rendered, patches));
+    CHECK(patches.empty());
+
+    // A new high moves the normalization range: only a full frame will do
+    bars.back().high = 20;
+    CHECK(!RenderEngine::patchLiveBars({"candlestick"}, "s", bars, rendered, patches));
+
+    return testResult("RenderEngineTest");
+}
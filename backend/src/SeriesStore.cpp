@@ -0,0 +1,179 @@
+// SeriesStore.cpp
+
+#include "SeriesStore.hpp"
+
+#include <algorithm>
+
+SeriesStore& SeriesStore::instance() {
+    static SeriesStore store;
+    return store;
+}
+
+void SeriesStore::publishBars(
+    const std::string& seriesId,
+    const std::vector<OhlcPoint>& bars,
+    int64_t ingestUs
+) {
+    if (bars.empty()) return;
+
+    uint64_t version = 0;
+    std::vector<Listener> toNotify;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Series& s = series_[seriesId];
+        for (const auto& bar : bars) {
+            if (!s.bars.empty() && s.bars.back().timestamp == bar.timestamp) {
+                s.bars.back() = bar;
+                s.range.set(s.bars.size() - 1, bar.low, bar.high);
+            } else if (s.bars.empty() || s.bars.back().timestamp < bar.timestamp) {
+                s.bars.push_back(bar);
+                s.range.push(bar.low, bar.high);
+            }
+            // Older than the last bar: history is append-only, drop it
+        }
+        version = ++s.version;
+        s.ingests.push_back(ingestUs);
+        if (s.ingests.size() > kIngestHistory) s.ingests.pop_front();
+
+        for (const auto& [token, reg] : listeners_) {
+            if (reg.seriesId == seriesId) toNotify.push_back(reg.listener);
+        }
+    }
+
+    // Listeners may call back into the store (snapshot, removeListener)
+    for (const auto& l : toNotify) {
+        l(seriesId, version);
+    }
+}
+
+std::vector<OhlcPoint> SeriesStore::snapshot(
+    const std::string& seriesId,
+    uint64_t* version,
+    int64_t* ingestUs
+) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = series_.find(seriesId);
+    if (it == series_.end()) {
+        if (version)  *version  = 0;
+        if (ingestUs) *ingestUs = 0;
+        return {};
+    }
+    if (version)  *version  = it->second.version;
+    if (ingestUs) *ingestUs = ingestSince(it->second, 0);
+    return it->second.bars;
+}
+
+int64_t SeriesStore::ingestSince(const Series& s, uint64_t sinceVersion) {
+    if (s.ingests.empty()) return 0;
+    const size_t newer = sinceVersion == 0 || sinceVersion >= s.version
+        ? 1
+        : size_t(std::min<uint64_t>(s.version - sinceVersion, s.ingests.size()));
+    int64_t earliest = 0;
+    for (auto it = s.ingests.end() - newer; it != s.ingests.end(); ++it) {
+        if (*it != 0 && (earliest == 0 || *it < earliest)) earliest = *it;
+    }
+    return earliest;
+}
+
+void SeriesStore::window(const Series& s, int64_t t0, int64_t t1, size_t& first, size_t& last) {
+    auto byTime = [](const OhlcPoint& bar, int64_t t) { return bar.timestamp < t; };
+    auto lo = std::lower_bound(s.bars.begin(), s.bars.end(), t0, byTime);
+    auto hi = t1 == INT64_MAX
+        ? s.bars.end()
+        : std::lower_bound(lo, s.bars.end(), t1 + 1, byTime);
+    first = size_t(lo - s.bars.begin());
+    last  = size_t(hi - s.bars.begin());
+}
+
+SeriesBounds SeriesStore::boundsOf(const Series& s, size_t first, size_t last) {
+    SeriesBounds b;
+    b.minT = s.bars[first].timestamp;
+    b.maxT = s.bars[last - 1].timestamp;
+    s.range.query(first, last - 1, b.minP, b.maxP);
+    return b;
+}
+
+std::vector<OhlcPoint> SeriesStore::snapshotRange(
+    const std::string& seriesId,
+    int64_t t0,
+    int64_t t1,
+    SeriesBounds* bounds,
+    uint64_t* version,
+    int64_t* ingestUs,
+    uint64_t sinceVersion
+) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bounds) *bounds = SeriesBounds{};
+    auto it = series_.find(seriesId);
+    if (it == series_.end()) {
+        if (version)  *version  = 0;
+        if (ingestUs) *ingestUs = 0;
+        return {};
+    }
+    const Series& s = it->second;
+    if (version)  *version  = s.version;
+    if (ingestUs) *ingestUs = ingestSince(s, sinceVersion);
+
+    size_t first = 0, last = 0;
+    window(s, t0, t1, first, last);
+    if (first == last) return {};
+    if (bounds) *bounds = boundsOf(s, first, last);
+    return std::vector<OhlcPoint>(s.bars.begin() + first, s.bars.begin() + last);
+}
+
+std::vector<OhlcPoint> SeriesStore::snapshotLast(
+    const std::string& seriesId,
+    size_t maxBars,
+    SeriesBounds* bounds,
+    uint64_t* version,
+    int64_t* ingestUs,
+    uint64_t sinceVersion
+) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bounds) *bounds = SeriesBounds{};
+    auto it = series_.find(seriesId);
+    if (it == series_.end()) {
+        if (version)  *version  = 0;
+        if (ingestUs) *ingestUs = 0;
+        return {};
+    }
+    const Series& s = it->second;
+    if (version)  *version  = s.version;
+    if (ingestUs) *ingestUs = ingestSince(s, sinceVersion);
+
+    const size_t last  = s.bars.size();
+    const size_t first = maxBars == 0 || maxBars >= last ? 0 : last - maxBars;
+    if (first == last) return {};
+    if (bounds) *bounds = boundsOf(s, first, last);
+    return std::vector<OhlcPoint>(s.bars.begin() + first, s.bars.end());
+}
+
+bool SeriesStore::priceRange(const std::string& seriesId, int64_t t0, int64_t t1, SeriesBounds& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = series_.find(seriesId);
+    if (it == series_.end()) return false;
+
+    size_t first = 0, last = 0;
+    window(it->second, t0, t1, first, last);
+    if (first == last) return false;
+    out = boundsOf(it->second, first, last);
+    return true;
+}
+
+uint64_t SeriesStore::version(const std::string& seriesId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = series_.find(seriesId);
+    return it == series_.end() ? 0 : it->second.version;
+}
+
+uint64_t SeriesStore::addListener(const std::string& seriesId, Listener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t token = nextToken_++;
+    listeners_.emplace(token, Registration{seriesId, std::move(listener)});
+    return token;
+}
+
+void SeriesStore::removeListener(uint64_t token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listeners_.erase(token);
+}
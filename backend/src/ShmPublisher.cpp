@@ -0,0 +1,125 @@
+// ShmPublisher.cpp
+// Renders live series once per change and broadcasts them over shared memory
+
+#include "ShmPublisher.hpp"
+#include "BinaryFrame.hpp"
+#include "ChartGeneratorFactory.hpp"
+#include "RenderEngine.hpp"
+#include "SeriesStore.hpp"
+#include "Tracing.hpp"
+
+#include <iostream>
+
+ShmPublisher::ShmPublisher(ShmPublisherConfig config)
+    : config_(std::move(config)) {}
+
+ShmPublisher::~ShmPublisher() {
+    stop();
+}
+
+bool ShmPublisher::start() {
+    if (running_.load()) return true;
+
+    std::string error;
+    if (!ring_.create(config_.name, config_.slotCount, config_.slotBytes, error)) {
+        std::cerr << "[ShmPublisher] " << error << "\n";
+        return false;
+    }
+
+    // Vertex bytes of a full window; strings and headers come on top
+    size_t windowBytes = 0;
+    for (const auto& type : config_.seriesTypes) {
+        if (auto gen = ChartGeneratorFactory::create(type)) windowBytes += gen->floatsPerBar() * sizeof(float);
+    }
+    windowBytes *= config_.maxBars;
+    if (config_.maxBars == 0 || windowBytes >= config_.slotBytes) {
+        std::cerr << "[ShmPublisher] A window of "
+                  << (config_.maxBars ? std::to_string(config_.maxBars) : std::string("unlimited"))
+                  << " bars may not fit the " << config_.slotBytes
+                  << " byte slot size; lower SHM_RING_MAX_BARS or raise SHM_RING_SLOT_BYTES\n";
+    }
+
+    running_ = true;
+    stopping_ = false;
+    worker_ = std::thread(&ShmPublisher::run, this);
+
+    for (const auto& source : config_.sources) {
+        storeTokens_.push_back(SeriesStore::instance().addListener(
+            source, [this](const std::string& id, uint64_t) { markDirty(id); }));
+        // Publish whatever is already there so readers start with a full frame
+        markDirty(source);
+    }
+
+    std::cout << "[ShmPublisher] Publishing " << config_.sources.size() << " series to '"
+              << config_.name << "' (" << config_.slotCount << " x "
+              << config_.slotBytes << " byte slots, last " << config_.maxBars << " bars)\n";
+    return true;
+}
+
+void ShmPublisher::stop() {
+    if (!running_.exchange(false)) return;
+    for (uint64_t token : storeTokens_) SeriesStore::instance().removeListener(token);
+    storeTokens_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (worker_.joinable()) worker_.join();
+
+    std::cout << "[ShmPublisher] Stopped after " << framesPublished() << " frames ("
+              << framesTooLarge() << " too large for a slot)\n";
+}
+
+void ShmPublisher::markDirty(const std::string& source) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty_.insert(source);
+    }
+    wake_.notify_one();
+}
+
+void ShmPublisher::run() {
+    std::set<std::string> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !dirty_.empty(); });
+            if (stopping_) return;
+            batch.swap(dirty_);
+        }
+        // Publishes that land while we render re-mark the source, so the
+        // ring always ends on the latest version
+        for (const auto& source : batch) publish(source);
+        batch.clear();
+    }
+}
+
+void ShmPublisher::publish(const std::string& source) {
+    BinaryFrame frame;
+    frame.source = source;
+    SeriesBounds bounds;
+    uint64_t& lastVersion = renderedVersion_[source];
+    auto bars = SeriesStore::instance().snapshotLast(source, config_.maxBars, &bounds,
+                                                     &frame.version, &frame.ingestUs, lastVersion);
+    lastVersion = frame.version;
+    if (bars.empty()) return;
+
+    std::vector<RenderedSeries> rendered;
+    frame.commands = RenderEngine::renderLiveBars(config_.seriesTypes, source, bars, rendered, &bounds);
+    frame.genEndUs = monotonicMicros();
+
+    encodeBinaryFrame(frame, encoded_);
+    if (ring_.write(encoded_.data(), encoded_.size())) {
+        framesPublished_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        // Readers see nothing new while this lasts, so keep saying so
+        const uint64_t dropped = framesTooLarge_.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (dropped == 1 || dropped % 1000 == 0) {
+            std::cerr << "[ShmPublisher] '" << source << "' frame is " << encoded_.size()
+                      << " bytes, over the " << ring_.slotBytes() << " byte slot size ("
+                      << dropped << " dropped so far); lower SHM_RING_MAX_BARS or raise"
+                      << " SHM_RING_SLOT_BYTES\n";
+        }
+    }
+}
@@ -0,0 +1,271 @@
+// ShmRing.cpp
+// POSIX shared-memory frame ring: writer and reader halves
+
+#include "ShmRing.hpp"
+#include "Tracing.hpp"
+
+#include <cstring>
+#include <new>
+
+#if defined(CHART_HAS_SHM)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+constexpr uint64_t kCacheLine = 64;
+
+uint64_t slotStride(uint32_t slotBytes) {
+    uint64_t raw = sizeof(ShmSlotHeader) + uint64_t(slotBytes);
+    return (raw + kCacheLine - 1) / kCacheLine * kCacheLine;
+}
+
+uint64_t headerSize() {
+    return (sizeof(ShmRingHeader) + kCacheLine - 1) / kCacheLine * kCacheLine;
+}
+
+#if defined(CHART_HAS_SHM)
+std::string errnoText(const char* what, const std::string& name) {
+    return std::string(what) + " '" + name + "': " + std::strerror(errno);
+}
+#endif
+} // namespace
+
+// ————————————————————————————————————————————————————————————————
+//  Writer
+// ————————————————————————————————————————————————————————————————
+
+ShmRingWriter::~ShmRingWriter() {
+    close();
+}
+
+bool ShmRingWriter::create(
+    const std::string& name,
+    uint32_t slotCount,
+    uint32_t slotBytes,
+    std::string& error
+) {
+#if defined(CHART_HAS_SHM)
+    close();
+    if (slotCount < 2 || slotBytes == 0) {
+        error = "ring needs at least 2 slots of non-zero size";
+        return false;
+    }
+
+    const uint64_t stride = slotStride(slotBytes);
+    const size_t   size   = size_t(headerSize() + stride * slotCount);
+
+    // Start from a fresh object: readers still mapping a previous run keep
+    // their old pages instead of seeing them truncated under them
+    ::shm_unlink(name.c_str());
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        error = errnoText("shm_open", name);
+        return false;
+    }
+    if (::ftruncate(fd, off_t(size)) != 0) {
+        error = errnoText("ftruncate", name);
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        error = errnoText("mmap", name);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+
+    name_      = name;
+    base_      = static_cast<uint8_t*>(p);
+    mapSize_   = size;
+    slotCount_ = slotCount;
+    slotBytes_ = slotBytes;
+    stride_    = stride;
+
+    // ftruncate zero-fills, so every stamp already reads as "never written"
+    header_ = new (base_) ShmRingHeader;
+    header_->layoutVersion = kShmRingLayoutVersion;
+    header_->slotCount     = slotCount;
+    header_->slotBytes     = slotBytes;
+    header_->slotStride    = stride;
+    header_->writeSeq.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        new (base_ + headerSize() + stride * i) ShmSlotHeader;
+    }
+    header_->magic.store(kShmRingMagic, std::memory_order_release);
+    return true;
+#else
+    (void)name; (void)slotCount; (void)slotBytes;
+    error = "shared-memory transport needs POSIX shm_open";
+    return false;
+#endif
+}
+
+bool ShmRingWriter::write(const uint8_t* data, size_t size) {
+    if (!header_ || size > slotBytes_) return false;
+
+    const uint64_t seq  = header_->writeSeq.load(std::memory_order_relaxed);
+    uint8_t*       raw  = base_ + headerSize() + stride_ * (seq % slotCount_);
+    auto*          slot = reinterpret_cast<ShmSlotHeader*>(raw);
+
+    // Odd stamp first: a reader that copies across this point sees the stamp
+    // change and discards what it read
+    slot->stamp.store(2 * seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(raw + sizeof(ShmSlotHeader), data, size);
+    slot->size      = uint32_t(size);
+    slot->publishUs = monotonicMicros();
+
+    slot->stamp.store(2 * seq + 2, std::memory_order_release);
+    header_->writeSeq.store(seq + 1, std::memory_order_release);
+    return true;
+}
+
+void ShmRingWriter::close() {
+#if defined(CHART_HAS_SHM)
+    if (base_) {
+        ::munmap(base_, mapSize_);
+        ::shm_unlink(name_.c_str());
+    }
+#endif
+    base_    = nullptr;
+    header_  = nullptr;
+    mapSize_ = 0;
+}
+
+// ————————————————————————————————————————————————————————————————
+//  Reader
+// ————————————————————————————————————————————————————————————————
+
+ShmRingReader::~ShmRingReader() {
+    close();
+}
+
+bool ShmRingReader::open(const std::string& name, bool fromStart, std::string& error) {
+#if defined(CHART_HAS_SHM)
+    close();
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        error = errnoText("shm_open", name);
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || size_t(st.st_size) < headerSize()) {
+        error = "'" + name + "' is not a frame ring";
+        ::close(fd);
+        return false;
+    }
+    const size_t size = size_t(st.st_size);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        error = errnoText("mmap", name);
+        return false;
+    }
+
+    base_    = static_cast<const uint8_t*>(p);
+    mapSize_ = size;
+    header_  = reinterpret_cast<const ShmRingHeader*>(base_);
+
+    if (header_->magic.load(std::memory_order_acquire) != kShmRingMagic ||
+        header_->layoutVersion != kShmRingLayoutVersion) {
+        error = "'" + name + "' is not initialized or has an unknown layout";
+        close();
+        return false;
+    }
+    slotCount_ = header_->slotCount;
+    slotBytes_ = header_->slotBytes;
+    stride_    = header_->slotStride;
+    if (slotCount_ < 2 || stride_ < sizeof(ShmSlotHeader) + slotBytes_ ||
+        headerSize() + stride_ * slotCount_ > mapSize_) {
+        error = "'" + name + "' has an inconsistent header";
+        close();
+        return false;
+    }
+
+    const uint64_t head = header_->writeSeq.load(std::memory_order_acquire);
+    nextSeq_  = fromStart ? oldestAvailable(head) : head;
+    overruns_ = 0;
+    return true;
+#else
+    (void)name; (void)fromStart;
+    error = "shared-memory transport needs POSIX shm_open";
+    return false;
+#endif
+}
+
+const ShmSlotHeader* ShmRingReader::slotAt(uint64_t seq) const {
+    return reinterpret_cast<const ShmSlotHeader*>(
+        base_ + headerSize() + stride_ * (seq % slotCount_));
+}
+
+uint64_t ShmRingReader::oldestAvailable(uint64_t writeSeq) const {
+    // Leave one slot of margin: the writer may already be rewriting the oldest
+    return writeSeq > slotCount_ - 1 ? writeSeq - (slotCount_ - 1) : 0;
+}
+
+uint64_t ShmRingReader::backlog() const {
+    if (!header_) return 0;
+    return header_->writeSeq.load(std::memory_order_acquire) - nextSeq_;
+}
+
+bool ShmRingReader::next(std::vector<uint8_t>& out, ShmFrameInfo* info) {
+    if (!header_) return false;
+
+    for (;;) {
+        const uint64_t head = header_->writeSeq.load(std::memory_order_acquire);
+        if (nextSeq_ >= head) return false;
+
+        // Lapped: everything before the oldest live slot is gone
+        const uint64_t oldest = oldestAvailable(head);
+        if (nextSeq_ < oldest) {
+            overruns_ += oldest - nextSeq_;
+            nextSeq_   = oldest;
+        }
+
+        const ShmSlotHeader* slot  = slotAt(nextSeq_);
+        const uint64_t       want  = 2 * nextSeq_ + 2;
+        const uint64_t       stamp = slot->stamp.load(std::memory_order_acquire);
+        if (stamp != want) {
+            // Already being overwritten with a later frame
+            ++overruns_;
+            ++nextSeq_;
+            continue;
+        }
+
+        const uint32_t size      = slot->size < slotBytes_ ? slot->size : slotBytes_;
+        const int64_t  publishUs = slot->publishUs;
+        out.resize(size);
+        std::memcpy(out.data(), reinterpret_cast<const uint8_t*>(slot) + sizeof(ShmSlotHeader), size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->stamp.load(std::memory_order_relaxed) != want) {
+            // The writer came round while we were copying
+            ++overruns_;
+            ++nextSeq_;
+            continue;
+        }
+
+        if (info) {
+            info->seq       = nextSeq_;
+            info->publishUs = publishUs;
+        }
+        ++nextSeq_;
+        return true;
+    }
+}
+
+void ShmRingReader::close() {
+#if defined(CHART_HAS_SHM)
+    if (base_) ::munmap(const_cast<uint8_t*>(base_), mapSize_);
+#endif
+    base_    = nullptr;
+    header_  = nullptr;
+    mapSize_ = 0;
+}
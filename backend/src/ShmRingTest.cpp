@@ -0,0 +1,195 @@
+// ShmRingTest.cpp
+// Frame ring: in-order delivery, overrun accounting and torn-read detection
+
+#include "ShmRing.hpp"
+#include "TestSupport.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+constexpr uint32_t kSlots     = 8;
+constexpr uint32_t kSlotBytes = 512;
+
+// Payload of frame `seq`: its number, then a fill byte derived from it, so a
+// frame mixed from two writes cannot pass verify()
+std::vector<uint8_t> makeFrame(uint64_t seq, size_t base = 16) {
+    std::vector<uint8_t> f(base + seq % 400, uint8_t(seq * 31 + 7));
+    std::memcpy(f.data(), &seq, sizeof(seq));
+    return f;
+}
+
+bool verify(const std::vector<uint8_t>& f, uint64_t seq, size_t base = 16) {
+    return f == makeFrame(seq, base);
+}
+
+std::string ringName(const char* suffix) {
+    return "/chart_ring_test_" + std::to_string(::getpid()) + "_" + suffix;
+}
+
+void testInOrder() {
+    ShmRingWriter writer;
+    ShmRingReader reader;
+    std::string   error;
+    const std::string name = ringName("order");
+    CHECK(writer.create(name, kSlots, kSlotBytes, error));
+    CHECK(reader.open(name, false, error));
+
+    std::vector<uint8_t> buf;
+    ShmFrameInfo         info;
+    CHECK(!reader.next(buf, &info));  // nothing published yet
+
+    for (uint64_t seq = 0; seq < kSlots - 1; ++seq) {
+        auto f = makeFrame(seq);
+        CHECK(writer.write(f.data(), f.size()));
+    }
+    CHECK(reader.backlog() == kSlots - 1);
+    for (uint64_t seq = 0; seq < kSlots - 1; ++seq) {
+        CHECK(reader.next(buf, &info));
+        CHECK(info.seq == seq);
+        CHECK(verify(buf, seq));
+    }
+    CHECK(!reader.next(buf, &info));
+    CHECK(reader.overruns() == 0);
+
+    std::vector<uint8_t> tooLarge(kSlotBytes + 1);
+    CHECK(!writer.write(tooLarge.data(), tooLarge.size()));
+}
+
+void testOverrun() {
+    ShmRingWriter writer;
+    ShmRingReader reader;
+    std::string   error;
+    const std::string name = ringName("overrun");
+    CHECK(writer.create(name, kSlots, kSlotBytes, error));
+    CHECK(reader.open(name, true, error));
+
+    const uint64_t total = 3 * kSlots;
+    for (uint64_t seq = 0; seq < total; ++seq) {
+        auto f = makeFrame(seq);
+        writer.write(f.data(), f.size());
+    }
+
+    // A lapped reader skips to the oldest frame the writer cannot be
+    // rewriting (one slot of margin) and counts everything before it
+    std::vector<uint8_t> buf;
+    ShmFrameInfo         info;
+    const uint64_t oldest = total - (kSlots - 1);
+    uint64_t expect = oldest;
+    while (reader.next(buf, &info)) {
+        CHECK(info.seq == expect);
+        CHECK(verify(buf, info.seq));
+        ++expect;
+    }
+    CHECK(expect == total);
+    CHECK(reader.overruns() == oldest);
+
+    // A reader opened late starts at the head
+    ShmRingReader late;
+    CHECK(late.open(name, false, error));
+    CHECK(!late.next(buf, &info));
+    CHECK(late.backlog() == 0);
+}
+
+// Sets the stamp of the slot holding frame `seq` through a second, writable
+// mapping, as if the writer were in the middle of overwriting it
+void setStamp(const std::string& name, uint64_t seq, uint64_t stamp) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+    ShmRingHeader probe;
+    CHECK(::pread(fd, &probe, sizeof(probe), 0) == ssize_t(sizeof(probe)));
+    const uint64_t headerBytes = (sizeof(ShmRingHeader) + 63) / 64 * 64;
+    const size_t   size = size_t(headerBytes + probe.slotStride * probe.slotCount);
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    CHECK(p != MAP_FAILED);
+    if (p == MAP_FAILED) return;
+    auto* slot = reinterpret_cast<ShmSlotHeader*>(
+        static_cast<uint8_t*>(p) + headerBytes + probe.slotStride * (seq % probe.slotCount));
+    slot->stamp.store(stamp, std::memory_order_release);
+    ::munmap(p, size);
+}
+
+// A slot whose stamp no longer matches the frame the reader wants is being
+// rewritten with a later one: it is skipped and counted, never handed out
+void testStaleStamp() {
+    ShmRingWriter writer;
+    ShmRingReader reader;
+    std::string   error;
+    const std::string name = ringName("stamp");
+    CHECK(writer.create(name, kSlots, kSlotBytes, error));
+    CHECK(reader.open(name, true, error));
+
+    for (uint64_t seq = 0; seq < 4; ++seq) {
+        auto f = makeFrame(seq);
+        writer.write(f.data(), f.size());
+    }
+    setStamp(name, 1, 2 * (1 + kSlots) + 1);  // frame 1 + kSlots half written
+
+    std::vector<uint8_t> buf;
+    ShmFrameInfo         info;
+    CHECK(reader.next(buf, &info) && info.seq == 0 && verify(buf, 0));
+    CHECK(reader.next(buf, &info) && info.seq == 2 && verify(buf, 2));
+    CHECK(reader.overruns() == 1);
+    CHECK(reader.next(buf, &info) && info.seq == 3 && verify(buf, 3));
+    CHECK(!reader.next(buf, &info));
+}
+
+// Concurrent writer and reader: every frame handed out must be intact, in
+// order, and frames read plus overruns must account for every write. Two
+// large slots make the writer lap the reader mid-copy regularly.
+void testConcurrent() {
+    constexpr size_t kBase = 64 * 1024;
+    ShmRingWriter writer;
+    ShmRingReader reader;
+    std::string   error;
+    const std::string name = ringName("race");
+    CHECK(writer.create(name, 2, kBase + 512, error));
+    CHECK(reader.open(name, true, error));
+
+    constexpr uint64_t kFrames = 20000;
+    std::atomic<bool>  done{false};
+    std::thread producer([&] {
+        for (uint64_t seq = 0; seq < kFrames; ++seq) {
+            auto f = makeFrame(seq, kBase);
+            writer.write(f.data(), f.size());
+        }
+        done = true;
+    });
+
+    std::vector<uint8_t> buf;
+    ShmFrameInfo         info;
+    uint64_t read = 0, torn = 0, outOfOrder = 0, last = 0;
+    bool     first = true;
+    for (;;) {
+        const bool finished = done.load();
+        while (reader.next(buf, &info)) {
+            if (!verify(buf, info.seq, kBase)) ++torn;
+            if (!first && info.seq <= last) ++outOfOrder;
+            last  = info.seq;
+            first = false;
+            ++read;
+        }
+        if (finished) break;
+    }
+    producer.join();
+
+    CHECK(torn == 0);
+    CHECK(outOfOrder == 0);
+    CHECK(read > 0);
+    CHECK(read + reader.overruns() == kFrames);
+}
+} // namespace
+
+int main() {
+    testInOrder();
+    testOverrun();
+    testStaleStamp();
+    testConcurrent();
+    return testResult("ShmRingTest");
+}
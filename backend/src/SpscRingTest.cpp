@@ -0,0 +1,109 @@
+// SpscRingTest.cpp
+// SpscRing: capacity rounding, full/empty edges, partial bulk transfers and
+// index wrap-around, single-threaded and with a real producer/consumer pair
+
+#include "SpscRing.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+void testCapacity() {
+    CHECK(SpscRing<int>(0).capacity() == 2);
+    CHECK(SpscRing<int>(1).capacity() == 2);
+    CHECK(SpscRing<int>(5).capacity() == 8);
+    CHECK(SpscRing<int>(8).capacity() == 8);
+    CHECK(SpscRing<int>(1000).capacity() == 1024);
+}
+
+void testFullAndEmpty() {
+    SpscRing<int> ring(4);
+    int out[8];
+    CHECK(ring.popBulk(out, 8) == 0);
+
+    for (int i = 0; i < 4; ++i) CHECK(ring.tryPush(i));
+    CHECK(!ring.tryPush(4));
+    const int more[2] = {4, 5};
+    CHECK(ring.pushBulk(more, 2) == 0);
+
+    CHECK(ring.popBulk(out, 1) == 1 && out[0] == 0);
+    CHECK(ring.tryPush(4));
+    CHECK(!ring.tryPush(5));
+
+    CHECK(ring.popBulk(out, 8) == 4);
+    CHECK(out[0] == 1 && out[1] == 2 && out[2] == 3 && out[3] == 4);
+    CHECK(ring.popBulk(out, 8) == 0);
+}
+
+// Random bulk sizes on both sides, far past the capacity, so every slot
+// boundary is crossed and partial pushes/pops happen constantly
+void testWrapAround() {
+    SpscRing<uint32_t> ring(16);
+    std::mt19937 rng(3);
+    uint32_t nextIn = 0, nextOut = 0;
+    std::vector<uint32_t> buf(40);
+
+    for (int round = 0; round < 20000; ++round) {
+        const size_t want = rng() % 40;
+        for (size_t i = 0; i < want; ++i) buf[i] = nextIn + uint32_t(i);
+        const size_t inFlight = nextIn - nextOut;
+        const size_t pushed = ring.pushBulk(buf.data(), want);
+        CHECK(pushed == std::min(want, ring.capacity() - inFlight));
+        nextIn += uint32_t(pushed);
+
+        const size_t take = rng() % 40;
+        const size_t popped = ring.popBulk(buf.data(), take);
+        CHECK(popped == std::min(take, size_t(nextIn - nextOut)));
+        for (size_t i = 0; i < popped; ++i) {
+            CHECK(buf[i] == nextOut);
+            ++nextOut;
+        }
+    }
+    CHECK(nextOut > 100000);
+}
+
+// One producer, one consumer: everything arrives once, in order
+void testThreads() {
+    constexpr uint64_t kCount = 2000000;
+    SpscRing<uint64_t> ring(1024);
+    std::thread producer([&ring] {
+        uint64_t batch[64];
+        uint64_t next = 0;
+        while (next < kCount) {
+            const size_t n = size_t(std::min<uint64_t>(1 + next % 64, kCount - next));
+            for (size_t i = 0; i < n; ++i) batch[i] = next + i;
+            size_t done = 0;
+            while (done < n) {
+                const size_t k = ring.pushBulk(batch + done, n - done);
+                if (k == 0) std::this_thread::yield();
+                done += k;
+            }
+            next += n;
+        }
+    });
+
+    uint64_t out[100];
+    uint64_t expected = 0;
+    bool inOrder = true;
+    while (expected < kCount) {
+        const size_t n = ring.popBulk(out, 100);
+        if (n == 0) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i) inOrder &= out[i] == expected++;
+    }
+    producer.join();
+    CHECK(inOrder);
+    CHECK(ring.popBulk(out, 100) == 0);
+}
+}  // namespace
+
+int main() {
+    testCapacity();
+    testFullAndEmpty();
+    testWrapAround();
+    testThreads();
+    return testResult("spsc_ring_test");
+}
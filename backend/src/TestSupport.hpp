@@ -0,0 +1,28 @@
+#pragma once
+
+// Minimal checks for the test executables built next to chart_server and
+// run by ctest: a failed CHECK is reported and the test exits non-zero.
+
+#include <iostream>
+
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            ++testFailures();                                                    \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+        }                                                                        \
+    } while (0)
+
+inline int testResult(const char* name) {
+    if (testFailures() != 0) {
+        std::cerr << "[" << name << "] " << testFailures() << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "[" << name << "] passed\n";
+    return 0;
+}
@@ -0,0 +1,109 @@
+// TickAggregator.cpp
+// Folds raw ticks from the ingest ring into OHLC bars and publishes them
+
+#include "TickAggregator.hpp"
+#include "SeriesStore.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+constexpr size_t kPopBatch = 4096;
+
+// Re-publish the forming bar at most this often while the ring stays busy
+constexpr auto kPublishInterval = std::chrono::milliseconds(1);
+
+int64_t bucketStart(int64_t ts, int64_t intervalMs) {
+    int64_t r = ts % intervalMs;
+    if (r < 0) r += intervalMs;
+    return ts - r;
+}
+} // namespace
+
+TickAggregator::TickAggregator(
+    SpscRing<Tick>& ring,
+    std::string seriesId,
+    int64_t intervalMs
+)
+    : ring_(ring),
+      seriesId_(std::move(seriesId)),
+      intervalMs_(intervalMs > 0 ? intervalMs : 60000) {}
+
+TickAggregator::~TickAggregator() {
+    stop();
+}
+
+void TickAggregator::start() {
+    if (running_.exchange(true)) return;
+    worker_ = std::thread(&TickAggregator::run, this);
+}
+
+void TickAggregator::stop() {
+    if (!running_.exchange(false)) return;
+    if (worker_.joinable()) worker_.join();
+}
+
+void TickAggregator::apply(const Tick& t) {
+    const int64_t bucket = bucketStart(t.timestamp, intervalMs_);
+
+    if (!hasForming_ || bucket > forming_.timestamp) {
+        if (hasForming_) pending_.push_back(forming_);
+        forming_    = OhlcPoint{bucket, t.price, t.price, t.price, t.price, t.size};
+        hasForming_ = true;
+    } else if (bucket == forming_.timestamp) {
+        forming_.high    = std::max(forming_.high, t.price);
+        forming_.low     = std::min(forming_.low,  t.price);
+        forming_.close   = t.price;
+        forming_.volume += t.size;
+    } else {
+        // Belongs to a bar that is already closed
+        ticksDropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (!dirty_) pendingRecvUs_ = t.recvUs;
+    dirty_ = true;
+}
+
+void TickAggregator::flush() {
+    if (!dirty_) return;
+    pending_.push_back(forming_);
+    SeriesStore::instance().publishBars(seriesId_, pending_, pendingRecvUs_);
+    pending_.clear();
+    dirty_ = false;
+}
+
+void TickAggregator::run() {
+    std::vector<Tick> batch(kPopBatch);
+    auto lastPublish = std::chrono::steady_clock::now();
+    unsigned idleSpins = 0;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        const size_t n = ring_.popBulk(batch.data(), batch.size());
+        for (size_t i = 0; i < n; ++i) {
+            apply(batch[i]);
+        }
+        ticksProcessed_.fetch_add(n, std::memory_order_relaxed);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (n < batch.size() || now - lastPublish >= kPublishInterval) {
+            flush();
+            lastPublish = now;
+        }
+
+        if (n == 0) {
+            // Spin briefly to catch bursts, then back off so an idle feed costs nothing
+            if (++idleSpins < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        } else {
+            idleSpins = 0;
+        }
+    }
+
+    flush();
+    std::cout << "[TickAggregator] '" << seriesId_ << "' stopped after "
+              << ticksProcessed() << " ticks (" << ticksDropped() << " late)\n";
+}
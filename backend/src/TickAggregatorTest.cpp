@@ -0,0 +1,96 @@
+// TickAggregatorTest.cpp
+// TickAggregator: interval bucketing (negative timestamps included), late
+// ticks dropped, and the forming bar re-published in place
+
+#include "SeriesStore.hpp"
+#include "TestSupport.hpp"
+#include "TickAggregator.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+constexpr int64_t kInterval = 60000;
+
+// Pushes `ticks`, lets the aggregator drain them and stops it, which
+// publishes whatever is pending. State carries over to the next call.
+void feed(TickAggregator& agg, SpscRing<Tick>& ring, const std::vector<Tick>& ticks) {
+    CHECK(ring.pushBulk(ticks.data(), ticks.size()) == ticks.size());
+    const uint64_t target = agg.ticksProcessed() + ticks.size();
+    agg.start();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (agg.ticksProcessed() < target && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    agg.stop();
+    CHECK(agg.ticksProcessed() == target);
+}
+
+bool sameBar(const OhlcPoint& b, int64_t t, double o, double h, double l, double c, double v) {
+    return b.timestamp == t && b.open == o && b.high == h && b.low == l && b.close == c && b.volume == v;
+}
+
+void testBuckets() {
+    const std::string id = "tick_aggregator_test";
+    SpscRing<Tick> ring(1024);
+    TickAggregator agg(ring, id, kInterval);
+
+    // Negative timestamps floor to the interval below, not toward zero.
+    // The forming bar (60000) is published along with the closed ones.
+    feed(agg, ring, {{-60001, 10, 1}, {-1, 11, 2}, {0, 12, 1}, {59999, 9, 1}, {60000, 13, 3}});
+    auto bars = SeriesStore::instance().snapshot(id);
+    CHECK(bars.size() == 4);
+    if (bars.size() == 4) {
+        CHECK(sameBar(bars[0], -120000, 10, 10, 10, 10, 1));
+        CHECK(sameBar(bars[1], -60000, 11, 11, 11, 11, 2));
+        CHECK(sameBar(bars[2], 0, 12, 12, 9, 9, 2));
+        CHECK(sameBar(bars[3], 60000, 13, 13, 13, 13, 3));
+    }
+
+    // More ticks for the forming bar update it in place
+    uint64_t before = SeriesStore::instance().version(id);
+    feed(agg, ring, {{60500, 14, 1}});
+    bars = SeriesStore::instance().snapshot(id);
+    CHECK(SeriesStore::instance().version(id) > before);
+    CHECK(bars.size() == 4);
+    if (bars.size() == 4) CHECK(sameBar(bars[3], 60000, 13, 14, 13, 14, 4));
+
+    before = SeriesStore::instance().version(id);
+    feed(agg, ring, {{61000, 12.5, 1}, {119999, 13.5, 1}});
+    bars = SeriesStore::instance().snapshot(id);
+    CHECK(SeriesStore::instance().version(id) > before);
+    CHECK(bars.size() == 4);
+    if (bars.size() == 4) CHECK(sameBar(bars[3], 60000, 13, 14, 12.5, 13.5, 6));
+
+    // A tick for an already closed bar is dropped and changes nothing
+    before = SeriesStore::instance().version(id);
+    feed(agg, ring, {{30000, 100, 1}});
+    CHECK(agg.ticksDropped() == 1);
+    CHECK(SeriesStore::instance().version(id) == before);
+    const auto after = SeriesStore::instance().snapshot(id);
+    CHECK(after.size() == 4);
+    if (after.size() == 4) CHECK(sameBar(after[3], 60000, 13, 14, 12.5, 13.5, 6));
+    CHECK(after.size() == 4 && after[0].high == 10 && after[2].high == 12);
+
+    // A gap of several intervals starts a new bar at its own bucket
+    feed(agg, ring, {{600001, 20, 1}});
+    bars = SeriesStore::instance().snapshot(id);
+    CHECK(bars.size() == 5);
+    if (bars.size() == 5) CHECK(sameBar(bars[4], 600000, 20, 20, 20, 20, 1));
+}
+
+void testWire() {
+    const Tick t{-1234567, 101.25, 0.5};
+    unsigned char buf[kTickWireSize];
+    encodeTick(t, buf);
+    const Tick back = decodeTick(buf);
+    CHECK(back.timestamp == t.timestamp && back.price == t.price && back.size == t.size);
+    CHECK(back.recvUs == 0);
+}
+}  // namespace
+
+int main() {
+    testBuckets();
+    testWire();
+    return testResult("tick_aggregator_test");
+}
@@ -0,0 +1,107 @@
+// TickIngestServer.cpp
+// Local socket listener that feeds raw tick records into the SPSC ring
+
+#include "TickIngestServer.hpp"
+#include "Tracing.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+namespace net = boost::asio;
+
+namespace {
+constexpr size_t kReadChunk = 64 * 1024;
+}
+
+TickIngestServer::TickIngestServer(SpscRing<Tick>& ring, TickIngestConfig config)
+    : ring_(ring), config_(std::move(config)) {}
+
+void TickIngestServer::start() {
+    std::thread(&TickIngestServer::run, this).detach();
+}
+
+template <typename Socket>
+void TickIngestServer::pump(Socket& socket) {
+    // `buf` holds at most one partial record carried over from the last read
+    std::vector<unsigned char> buf(kReadChunk + kTickWireSize);
+    std::vector<Tick> decoded(kReadChunk / kTickWireSize + 1);
+    size_t carry = 0;
+    uint64_t count = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (;;) {
+        boost::system::error_code ec;
+        size_t n = socket.read_some(net::buffer(buf.data() + carry, kReadChunk), ec);
+        if (ec) break;  // eof or reset: feed is done
+
+        const int64_t recvUs = monotonicMicros();
+        size_t total   = carry + n;
+        size_t records = total / kTickWireSize;
+        for (size_t i = 0; i < records; ++i) {
+            decoded[i] = decodeTick(buf.data() + i * kTickWireSize);
+            decoded[i].recvUs = recvUs;
+        }
+
+        // Backpressure: hold the feed until the aggregator frees space
+        size_t pushed = 0;
+        while (pushed < records) {
+            size_t k = ring_.pushBulk(decoded.data() + pushed, records - pushed);
+            if (k == 0) std::this_thread::yield();
+            pushed += k;
+        }
+        count += records;
+        ticksReceived_.fetch_add(records, std::memory_order_relaxed);
+
+        carry = total - records * kTickWireSize;
+        if (carry) std::memmove(buf.data(), buf.data() + records * kTickWireSize, carry);
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "[TickIngest] Feed closed: " << count << " ticks in " << secs << " s ("
+              << (secs > 0 ? uint64_t(count / secs) : 0) << " ticks/s)";
+    if (carry) std::cout << ", discarded " << carry << " trailing bytes";
+    std::cout << "\n";
+}
+
+void TickIngestServer::run() {
+    try {
+        net::io_context ioc{1};
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        if (!config_.unixPath.empty()) {
+            using local = net::local::stream_protocol;
+            std::remove(config_.unixPath.c_str());  // stale socket from a previous run
+            local::acceptor acceptor{ioc, local::endpoint(config_.unixPath)};
+            std::cout << "[TickIngest] Listening on unix:" << config_.unixPath << "\n";
+            for (;;) {
+                local::socket socket{ioc};
+                acceptor.accept(socket);
+                pump(socket);
+            }
+        }
+#else
+        if (!config_.unixPath.empty()) {
+            std::cerr << "[TickIngest] Unix sockets unsupported on this platform, using TCP\n";
+        }
+#endif
+
+        using tcp = net::ip::tcp;
+        tcp::acceptor acceptor{ioc, {net::ip::address_v4::loopback(), config_.tcpPort}};
+        std::cout << "[TickIngest] Listening on 127.0.0.1:" << config_.tcpPort << "\n";
+        for (;;) {
+            tcp::socket socket{ioc};
+            acceptor.accept(socket);
+            socket.set_option(tcp::no_delay(true));
+            pump(socket);
+        }
+    } catch (std::exception const& e) {
+        std::cerr << "[TickIngest] Listener error: " << e.what() << "\n";
+    }
+}
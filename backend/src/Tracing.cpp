@@ -0,0 +1,50 @@
+// Tracing.cpp
+
+#include "Tracing.hpp"
+
+#include <algorithm>
+
+int LatencyHistogram::bucketFor(uint64_t v) {
+    // Values below 2^kSubBits get their own exact buckets
+    if (v < (1u << kSubBits)) return int(v);
+    int msb = 63;
+    while (!(v >> msb)) --msb;
+    int sub = int((v >> (msb - kSubBits)) & ((1u << kSubBits) - 1));
+    return ((msb - kSubBits + 1) << kSubBits) + sub;
+}
+
+int64_t LatencyHistogram::upperBound(int bucket) {
+    if (bucket < (1 << kSubBits)) return bucket;
+    int msb = (bucket >> kSubBits) + kSubBits - 1;
+    int sub = bucket & ((1 << kSubBits) - 1);
+    uint64_t lo = (uint64_t(1) << msb) + (uint64_t(sub) << (msb - kSubBits));
+    return int64_t(lo + (uint64_t(1) << (msb - kSubBits)) - 1);
+}
+
+void LatencyHistogram::record(int64_t us) {
+    if (us < 0) us = 0;  // clock skew between stages can't go backwards, but be safe
+    ++counts_[bucketFor(uint64_t(us))];
+    ++total_;
+    max_ = std::max(max_, us);
+}
+
+LatencySummary LatencyHistogram::summary() const {
+    LatencySummary s;
+    s.count = total_;
+    s.max   = max_;
+    if (total_ == 0) return s;
+
+    auto percentile = [&](double p) {
+        uint64_t rank = std::max<uint64_t>(1, uint64_t(p * total_ + 0.5));
+        uint64_t seen = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            seen += counts_[b];
+            if (seen >= rank) return std::min(upperBound(b), max_);
+        }
+        return max_;
+    };
+    s.p50 = percentile(0.50);
+    s.p90 = percentile(0.90);
+    s.p99 = percentile(0.99);
+    return s;
+}
@@ -0,0 +1,133 @@
+// TracingTest.cpp
+// LatencyHistogram bucket arithmetic and percentiles, and the ingest time a
+// frame merging several publishes is traced from
+
+#include "SeriesStore.hpp"
+#include "TestSupport.hpp"
+#include "Tracing.hpp"
+
+#include <cstdint>
+#include <random>
+
+namespace {
+using H = LatencyHistogram;
+
+// The buckets partition [0, 2^64): each value lands in the bucket whose
+// upper bound is the first one >= it, and a bucket is at most 1/8 of its
+// lower edge wide
+void checkValue(uint64_t v) {
+    const int b = H::bucketFor(v);
+    CHECK(b >= 0 && b < H::kBuckets);
+    CHECK(uint64_t(H::upperBound(b)) >= v);
+    if (b > 0) CHECK(uint64_t(H::upperBound(b - 1)) < v);
+}
+
+void testBuckets() {
+    // Small values are exact
+    for (uint64_t v = 0; v < (1u << H::kSubBits); ++v) {
+        CHECK(H::bucketFor(v) == int(v));
+        CHECK(H::upperBound(int(v)) == int64_t(v));
+    }
+
+    // Power-of-two edges: 2^k opens a bucket, 2^k - 1 closes the one before
+    for (int k = H::kSubBits; k < 63; ++k) {
+        const uint64_t p = uint64_t(1) << k;
+        const int b = H::bucketFor(p);
+        CHECK(H::bucketFor(p - 1) == b - 1);
+        CHECK(uint64_t(H::upperBound(b - 1)) == p - 1);
+        CHECK(uint64_t(H::upperBound(b)) == p + (p >> H::kSubBits) - 1);
+        // 8 linear sub-buckets per power of two
+        CHECK(H::bucketFor(2 * p - 1) == b + (1 << H::kSubBits) - 1);
+        for (uint64_t v : {p - 1, p, p + 1, p + (p >> H::kSubBits), 2 * p - 1}) checkValue(v);
+    }
+    CHECK(H::bucketFor(UINT64_MAX >> 1) < H::kBuckets);
+
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t v = rng() >> (rng() % 63 + 1);
+        checkValue(v);
+        const int b = H::bucketFor(v);
+        if (b >= (1 << H::kSubBits)) {
+            const uint64_t lo = uint64_t(H::upperBound(b - 1)) + 1;
+            CHECK(uint64_t(H::upperBound(b)) - lo + 1 <= (lo >> H::kSubBits) + 1);
+        }
+    }
+}
+
+// Percentiles report a bucket's upper bound (capped at the max), so they are
+// never below the true value and at most one bucket width above it
+void checkNear(int64_t got, int64_t want) {
+    CHECK(got >= want);
+    CHECK(got <= want + want / 8 + 1);
+}
+
+void testPercentiles() {
+    H empty;
+    CHECK(empty.summary().count == 0 && empty.summary().p99 == 0);
+
+    H uniform;
+    for (int64_t v = 1; v <= 1000; ++v) uniform.record(v);
+    auto s = uniform.summary();
+    CHECK(s.count == 1000 && s.max == 1000);
+    checkNear(s.p50, 500);
+    checkNear(s.p90, 900);
+    checkNear(s.p99, 990);
+
+    H point;
+    for (int i = 0; i < 100; ++i) point.record(777);
+    s = point.summary();
+    CHECK(s.p50 == 777 && s.p99 == 777 && s.max == 777);
+
+    // 2% slow outliers: p50/p90 stay fast, p99 lands on the outliers
+    H bimodal;
+    for (int i = 0; i < 980; ++i) bimodal.record(10);
+    for (int i = 0; i < 20; ++i) bimodal.record(50000);
+    s = bimodal.summary();
+    CHECK(s.p50 == 10 && s.p90 == 10);
+    CHECK(s.p99 == 50000);
+
+    // Ranks round to the nearest sample, and never to "before the first"
+    H one;
+    one.record(300);
+    CHECK(one.summary().p50 == 300 && one.summary().p99 == 300);
+    H three;
+    for (int64_t v : {10, 12, 14}) three.record(v);  // exact buckets below 16
+    s = three.summary();
+    CHECK(s.p50 == 12 && s.p90 == 14);
+
+    H skewed;
+    skewed.record(-5);  // clock skew is clamped to 0
+    s = skewed.summary();
+    CHECK(s.count == 1 && s.p50 == 0 && s.max == 0);
+}
+
+// A frame that folds several publishes is traced from the earliest one
+void testMergedIngest() {
+    const std::string id = "tracing_test";
+    auto& store = SeriesStore::instance();
+    for (int64_t i = 1; i <= 5; ++i) store.publishBars(id, {OhlcPoint{i, 1, 2, 0, 1}}, 1000 * i);
+
+    uint64_t version = 0;
+    int64_t  ingestUs = 0;
+    store.snapshotRange(id, INT64_MIN, INT64_MAX, nullptr, &version, &ingestUs);
+    CHECK(version == 5 && ingestUs == 5000);  // no previous frame: latest publish
+    store.snapshotRange(id, INT64_MIN, INT64_MAX, nullptr, &version, &ingestUs, 2);
+    CHECK(ingestUs == 3000);                  // publishes 3, 4 and 5 merged
+    store.snapshotLast(id, 2, nullptr, &version, &ingestUs, 4);
+    CHECK(ingestUs == 5000);
+
+    // Publishes with unknown ingest (0) do not hide the known ones
+    store.publishBars(id, {OhlcPoint{6, 1, 2, 0, 1}}, 0);
+    store.snapshotRange(id, INT64_MIN, INT64_MAX, nullptr, &version, &ingestUs, 4);
+    CHECK(ingestUs == 5000);
+    store.snapshotRange(id, INT64_MIN, INT64_MAX, nullptr, &version, &ingestUs, 5);
+    CHECK(ingestUs == 0);
+}
+}  // namespace
+
+int main() {
+    testBuckets();
+    testPercentiles();
+    testMergedIngest();
+    return testResult("tracing_test");
+}
@@ -0,0 +1,556 @@
+// backend/src/WebSocketSession.cpp
+
+#include "WebSocketSession.hpp"
+#include "Protocol.hpp"
+#include "RelayUpstream.hpp"
+#include "RenderEngine.hpp"
+#include "SeriesStore.hpp"
+#include "thumbnails/ThumbnailCache.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include <boost/asio/post.hpp>
+
+namespace beast     = boost::beast;
+namespace websocket = beast::websocket;
+namespace net       = boost::asio;
+using     tcp       = net::ip::tcp;
+
+namespace {
+const std::string kInvalidRequest = "Invalid JSON request";
+
+// Bounds per-connection state; a dashboard needs one per chart
+constexpr size_t kMaxSubscriptions = 256;
+
+// Bounds one thumbnails request; a watchlist page asks for a few hundred
+constexpr size_t kMaxThumbnails    = 1024;
+constexpr int    kMaxThumbnailSide = 1024;
+
+// Traced frames remembered for ack matching; older ones count as never acked
+constexpr size_t kMaxAwaitingAck   = 1024;
+
+// Relayed frames may queue per subscription before the client is resynced
+// from the relay cache instead (patches cannot be coalesced like renders)
+constexpr unsigned kMaxRelayQueued = 64;
+
+bool flag(const rapidjson::Document& req, const char* name) {
+    return req.HasMember(name) && req[name].IsBool() && req[name].GetBool();
+}
+
+// Optional millisecond timestamp member (e.g. a viewport edge)
+int64_t timeMember(const rapidjson::Document& req, const char* name, int64_t def) {
+    if (!req.HasMember(name)) return def;
+    const auto& v = req[name];
+    if (v.IsInt64())  return v.GetInt64();
+    if (v.IsNumber()) return int64_t(v.GetDouble());
+    return def;
+}
+
+std::string getEnvOr(const char* var, const char* def) {
+    const char* val = std::getenv(var);
+    return val ? val : def;
+}
+
+// Subscription id from "id" (string or number); empty when absent
+std::string requestId(const rapidjson::Document& req) {
+    if (!req.HasMember("id")) return {};
+    const auto& v = req["id"];
+    if (v.IsString()) return v.GetString();
+    if (v.IsInt64())  return std::to_string(v.GetInt64());
+    return {};
+}
+} // namespace
+
+WebSocketSession::WebSocketSession()
+    : ws_(ioc_) {}
+
+WebSocketSession::~WebSocketSession() {
+    clearSubscriptions();
+}
+
+tcp::socket& WebSocketSession::socket() {
+    return ws_.next_layer();
+}
+
+void WebSocketSession::run() {
+    try {
+        ws_.accept();  // complete handshake
+        ws_.text(true);
+        doRead();
+        ioc_.run();
+    } catch (std::exception const& e) {
+        std::cerr << "[WebSocket] Session error: " << e.what() << "\n";
+    }
+    clearSubscriptions();
+}
+
+// ─── Reading ─────────────────────────────────────────────────────────────
+
+void WebSocketSession::doRead() {
+    ws_.async_read(readBuf_,
+        [self = shared_from_this()](beast::error_code ec, std::size_t bytes) {
+            self->onRead(ec, bytes);
+        });
+}
+
+void WebSocketSession::onRead(beast::error_code ec, std::size_t) {
+    if (ec) {
+        if (ec != websocket::error::closed) {
+            std::cerr << "[WebSocket] Read error: " << ec.message() << "\n";
+        }
+        clearSubscriptions();
+        return;
+    }
+    std::string msg = beast::buffers_to_string(readBuf_.data());
+    readBuf_.consume(readBuf_.size());
+
+    handleMessage(msg);
+    doRead();
+}
+
+void WebSocketSession::handleMessage(const std::string& msg) {
+    rapidjson::Document req;
+    req.Parse(msg.c_str());
+    if (req.HasParseError() || !req.IsObject() ||
+        !req.HasMember("type") || !req["type"].IsString()) {
+        send(Protocol::serializeError(kInvalidRequest));
+        return;
+    }
+
+    std::string reqType = req["type"].GetString();
+    if (reqType == "subscribe") {
+        handleSubscribe(req);
+    } else if (reqType == "unsubscribe") {
+        handleUnsubscribe(req);
+    } else if (reqType == "thumbnails") {
+        handleThumbnails(req);
+    } else if (reqType == "viewport") {
+        handleViewport(req);
+    } else if (reqType == "ack") {
+        handleAck(req);
+    } else if (reqType == "stats") {
+        handleStats(req);
+    } else {
+        send(Protocol::serializeError(kInvalidRequest, requestId(req)));
+    }
+}
+
+void WebSocketSession::handleSubscribe(const rapidjson::Document& req) {
+    const std::string id = requestId(req);
+
+    // Collect requested series types (string or array)
+    std::vector<std::string> types;
+    if (req.HasMember("seriesTypes") && req["seriesTypes"].IsArray()) {
+        for (auto& v : req["seriesTypes"].GetArray()) {
+            if (v.IsString())
+                types.emplace_back(v.GetString());
+        }
+    } else if (req.HasMember("seriesType") && req["seriesType"].IsString()) {
+        types.emplace_back(req["seriesType"].GetString());
+    } else {
+        send(Protocol::serializeError(kInvalidRequest, id));
+        return;
+    }
+
+    // Re-subscribing with a known id replaces that subscription only
+    removeSubscription(id);
+    if (subscriptions_.size() >= kMaxSubscriptions) {
+        send(Protocol::serializeError("Too many subscriptions", id));
+        return;
+    }
+
+    auto sub = std::make_shared<Subscription>();
+    sub->id          = id;
+    sub->seriesTypes = std::move(types);
+    sub->traced      = flag(req, "trace");
+    sub->sequenced   = sub->traced || flag(req, "seq");
+    sub->patches     = flag(req, "patch");
+    sub->fromT       = timeMember(req, "from", INT64_MIN);
+    sub->toT         = timeMember(req, "to", INT64_MAX);
+
+    // "source" names a live series in SeriesStore (e.g. the tick aggregator output)
+    if (req.HasMember("source") && req["source"].IsString()) {
+        sub->source = req["source"].GetString();
+        subscriptions_[id] = sub;
+
+        if (RelayUpstream::instance().enabled()) {
+            attachRelay(sub);
+            return;
+        }
+
+        std::weak_ptr<WebSocketSession> weakSelf = shared_from_this();
+        std::weak_ptr<Subscription>     weakSub  = sub;
+        sub->storeToken = SeriesStore::instance().addListener(sub->source,
+            [weakSelf, weakSub](const std::string&, uint64_t) {
+                auto self = weakSelf.lock();
+                auto s    = weakSub.lock();
+                if (self && s) self->scheduleRefresh(s);
+            });
+        refreshLive(sub);
+        return;
+    }
+
+    FrameTrace trace;
+    trace.genStartUs = monotonicMicros();
+
+    // Load the same JSON array from disk once
+    std::string dataFile = getEnvOr("DATA_FILE_PATH", "data/sample_data.json");
+    std::ifstream ifs(dataFile);
+    if (!ifs.is_open()) {
+        send(Protocol::serializeError(kInvalidRequest, id));
+        return;
+    }
+    std::string jsonArray((std::istreambuf_iterator<char>(ifs)),
+                          std::istreambuf_iterator<char>());
+
+    // For each requested series, generate commands and collect
+    std::vector<DrawCommand> allCmds;
+    for (auto& st : sub->seriesTypes) {
+        auto cmds = RenderEngine::generateIncrementalDrawCommands(st, jsonArray, 0);
+        allCmds.insert(allCmds.end(), cmds.begin(), cmds.end());
+    }
+    trace.genEndUs = monotonicMicros();
+    subscriptions_[id] = sub;
+    sendDrawCommands(sub, allCmds, trace);
+}
+
+void WebSocketSession::handleUnsubscribe(const rapidjson::Document& req) {
+    // With an id, cancel just that subscription; without one, cancel all.
+    // The socket stays open either way: closing it is up to the client.
+    if (req.HasMember("id")) {
+        const std::string id = requestId(req);
+        removeSubscription(id);
+        send(Protocol::serializeUnsubscribed(id));
+        return;
+    }
+    clearSubscriptions();
+}
+
+// Pan/zoom on a live subscription: re-render just the new time window
+void WebSocketSession::handleViewport(const rapidjson::Document& req) {
+    const std::string id = requestId(req);
+    auto it = subscriptions_.find(id);
+    if (it == subscriptions_.end() || it->second->source.empty()) {
+        send(Protocol::serializeError("Unknown live subscription", id));
+        return;
+    }
+    const SubscriptionPtr& sub = it->second;
+    sub->fromT = timeMember(req, "from", INT64_MIN);
+    sub->toT   = timeMember(req, "to", INT64_MAX);
+    if (sub->relayToken) {
+        // Different window, different upstream channel
+        RelayUpstream::instance().detach(sub->relayToken);
+        attachRelay(sub);
+        return;
+    }
+    sub->rendered.clear();  // vertices are relative to the old window; next frame is full
+    refreshLive(sub);
+}
+
+void WebSocketSession::handleThumbnails(const rapidjson::Document& req) {
+    const std::string id = requestId(req);
+    if (!req.HasMember("sources") || !req["sources"].IsArray()) {
+        send(Protocol::serializeError(kInvalidRequest, id));
+        return;
+    }
+    // One batch per connection in flight, so a client looping requests
+    // cannot pile work onto the shared pool
+    if (thumbnailsPending_) {
+        send(Protocol::serializeError("Thumbnail request already pending", id));
+        return;
+    }
+
+    ThumbnailOptions opts;
+    if (req.HasMember("width") && req["width"].IsInt())
+        opts.width = std::clamp(req["width"].GetInt(), 1, kMaxThumbnailSide);
+    if (req.HasMember("height") && req["height"].IsInt())
+        opts.height = std::clamp(req["height"].GetInt(), 1, kMaxThumbnailSide);
+    std::string seriesType = "line";
+    if (req.HasMember("seriesType") && req["seriesType"].IsString())
+        seriesType = req["seriesType"].GetString();
+
+    std::vector<ThumbnailRequest> batch;
+    for (auto& v : req["sources"].GetArray()) {
+        if (!v.IsString()) continue;
+        if (batch.size() == kMaxThumbnails) break;
+        batch.push_back(ThumbnailRequest{v.GetString(), seriesType, opts});
+    }
+    // Misses render on the shared pool; live frames keep flowing meanwhile
+    thumbnailsPending_ = true;
+    std::weak_ptr<WebSocketSession> weakSelf = shared_from_this();
+    ThumbnailCache::instance().render(std::move(batch),
+        [weakSelf, id](std::vector<Thumbnail> images) {
+            auto session = weakSelf.lock();
+            if (!session) return;
+            std::string frame = Protocol::serializeThumbnails(images, id);
+            net::post(session->ioc_, [weakSelf, frame = std::move(frame)]() mutable {
+                auto self = weakSelf.lock();
+                if (!self) return;
+                self->thumbnailsPending_ = false;
+                self->send(std::move(frame));
+            });
+        });
+}
+
+void WebSocketSession::handleAck(const rapidjson::Document& req) {
+    if (!req.HasMember("seq") || !req["seq"].IsUint64()) return;
+    const uint64_t seq = req["seq"].GetUint64();
+    auto it = subscriptions_.find(requestId(req));
+    if (it == subscriptions_.end() || !it->second->traced) return;
+
+    // Acks normally arrive in order; anything skipped over was dropped client-side
+    Subscription& sub = *it->second;
+    const int64_t now = monotonicMicros();
+    while (!sub.awaitingAck.empty() && sub.awaitingAck.front().seq < seq) {
+        sub.awaitingAck.pop_front();
+    }
+    if (sub.awaitingAck.empty() || sub.awaitingAck.front().seq != seq) return;
+
+    const PendingAck& p = sub.awaitingAck.front();
+    sub.rtt.record(now - p.writeDoneUs);
+    if (p.ingestUs) sub.endToEnd.record(now - p.ingestUs);
+    ++sub.framesAcked;
+    sub.awaitingAck.pop_front();
+}
+
+void WebSocketSession::handleStats(const rapidjson::Document& req) {
+    std::vector<SubscriptionStats> stats;
+    for (const auto& [id, sub] : subscriptions_) {
+        if (sub->traced) stats.push_back(statsFor(*sub));
+    }
+    send(Protocol::serializeStats(stats, requestId(req)));
+}
+
+// ─── Writing ─────────────────────────────────────────────────────────────
+
+void WebSocketSession::send(std::string frame, SubscriptionPtr sub, uint64_t seq, int64_t ingestUs) {
+    if (sub) ++sub->queued;
+    outbox_.push_back(Outgoing{std::move(frame), std::move(sub), seq, ingestUs});
+    if (outbox_.size() == 1) doWrite();
+}
+
+void WebSocketSession::sendDrawCommands(
+    const SubscriptionPtr& sub,
+    const std::vector<DrawCommand>& cmds,
+    FrameTrace trace
+) {
+    const uint64_t seq = sub->sequenced ? sub->nextSeq++ : 0;
+    sendTraced(sub, Protocol::serializeDrawCommands(cmds, sub->id, seq), seq, trace);
+}
+
+void WebSocketSession::sendPatches(
+    const SubscriptionPtr& sub,
+    const std::vector<ChartingApp::SeriesPatch>& patches,
+    FrameTrace trace
+) {
+    const uint64_t seq = sub->sequenced ? sub->nextSeq++ : 0;
+    sendTraced(sub, Protocol::serializePatches(patches, sub->id, seq), seq, trace);
+}
+
+void WebSocketSession::sendTraced(
+    const SubscriptionPtr& sub,
+    std::string frame,
+    uint64_t seq,
+    FrameTrace trace
+) {
+    if (sub->traced) {
+        trace.enqueueUs = monotonicMicros();
+        Protocol::appendTrace(frame, trace);
+    }
+    send(std::move(frame), sub, seq, trace.ingestUs);
+}
+
+void WebSocketSession::doWrite() {
+    ws_.async_write(net::buffer(outbox_.front().frame),
+        [self = shared_from_this()](beast::error_code ec, std::size_t bytes) {
+            self->onWrite(ec, bytes);
+        });
+}
+
+void WebSocketSession::onWrite(beast::error_code ec, std::size_t) {
+    if (ec) {
+        std::cerr << "[WebSocket] Write error: " << ec.message() << "\n";
+        outbox_.clear();
+        clearSubscriptions();
+        return;
+    }
+    Outgoing done = std::move(outbox_.front());
+    outbox_.pop_front();
+    SubscriptionPtr sub = std::move(done.sub);
+    if (sub && sub->traced && done.seq) {
+        recordWrite(*sub, done.seq, done.ingestUs);
+    }
+    if (!outbox_.empty()) doWrite();
+
+    if (sub && --sub->queued == 0) {
+        if (sub->dirty) {
+            refreshLive(sub);
+        } else if (sub->relayStale) {
+            RelayUpstream::instance().replay(sub->relayToken);
+        }
+    }
+}
+
+// ─── Subscriptions ───────────────────────────────────────────────────────
+
+void WebSocketSession::removeSubscription(const std::string& id) {
+    auto it = subscriptions_.find(id);
+    if (it == subscriptions_.end()) return;
+    if (it->second->storeToken) {
+        SeriesStore::instance().removeListener(it->second->storeToken);
+    }
+    if (it->second->relayToken) {
+        RelayUpstream::instance().detach(it->second->relayToken);
+    }
+    logLatency(*it->second);
+    // Frames already queued still go out; the id just stops producing new ones
+    subscriptions_.erase(it);
+}
+
+void WebSocketSession::clearSubscriptions() {
+    for (auto& [id, sub] : subscriptions_) {
+        if (sub->storeToken) SeriesStore::instance().removeListener(sub->storeToken);
+        if (sub->relayToken) RelayUpstream::instance().detach(sub->relayToken);
+        logLatency(*sub);
+    }
+    subscriptions_.clear();
+}
+
+// ─── Latency tracing ─────────────────────────────────────────────────────
+
+void WebSocketSession::recordWrite(Subscription& sub, uint64_t seq, int64_t ingestUs) {
+    const int64_t now = monotonicMicros();
+    ++sub.framesSent;
+    if (ingestUs) sub.pipeline.record(now - ingestUs);
+    sub.awaitingAck.push_back(PendingAck{seq, ingestUs, now});
+    if (sub.awaitingAck.size() > kMaxAwaitingAck) sub.awaitingAck.pop_front();
+}
+
+SubscriptionStats WebSocketSession::statsFor(const Subscription& sub) {
+    SubscriptionStats st;
+    st.subscriptionId = sub.id;
+    st.framesSent     = sub.framesSent;
+    st.framesAcked    = sub.framesAcked;
+    st.pipeline       = sub.pipeline.summary();
+    st.rtt            = sub.rtt.summary();
+    st.endToEnd       = sub.endToEnd.summary();
+    return st;
+}
+
+// One line per traced subscription when it ends, so lagging clients show up in the log
+void WebSocketSession::logLatency(const Subscription& sub) {
+    if (!sub.traced || sub.framesSent == 0) return;
+    const SubscriptionStats st = statsFor(sub);
+    std::cout << "[Latency] '" << st.subscriptionId << "' frames=" << st.framesSent
+              << " acked=" << st.framesAcked
+              << " pipeline p50/p99=" << st.pipeline.p50 << "/" << st.pipeline.p99 << "us"
+              << " rtt p50/p99=" << st.rtt.p50 << "/" << st.rtt.p99 << "us"
+              << " endToEnd p50/p99=" << st.endToEnd.p50 << "/" << st.endToEnd.p99 << "us\n";
+}
+
+// Runs on the publisher's thread: coalesce bursts into one queued refresh
+void WebSocketSession::scheduleRefresh(const SubscriptionPtr& sub) {
+    if (sub->refreshPending.exchange(true)) return;
+    std::weak_ptr<WebSocketSession> weakSelf = shared_from_this();
+    std::weak_ptr<Subscription>     weakSub  = sub;
+    net::post(ioc_, [weakSelf, weakSub] {
+        auto self = weakSelf.lock();
+        auto s    = weakSub.lock();
+        if (!self || !s) return;
+        s->refreshPending = false;
+        self->refreshLive(s);
+    });
+}
+
+void WebSocketSession::refreshLive(const SubscriptionPtr& sub) {
+    // Cancelled while the refresh was queued
+    auto it = subscriptions_.find(sub->id);
+    if (it == subscriptions_.end() || it->second != sub) return;
+
+    // Keep at most one frame per subscription in flight; a slow client just
+    // sees fewer, fresher frames instead of a growing backlog
+    if (sub->queued > 0) {
+        sub->dirty = true;
+        return;
+    }
+    sub->dirty = false;
+
+    FrameTrace trace;
+    trace.genStartUs = monotonicMicros();
+    // The store's range index supplies the window's price range, so
+    // generators normalize without scanning the bars first
+    // Trace from the oldest publish this frame folds in, not the newest
+    SeriesBounds bounds;
+    uint64_t     version = 0;
+    auto bars = SeriesStore::instance().snapshotRange(sub->source, sub->fromT, sub->toT, &bounds,
+                                                      &version, &trace.ingestUs, sub->renderedVersion);
+    sub->renderedVersion = version;
+
+    // Usually only the forming bar moved: ship just the vertices that changed
+    std::vector<ChartingApp::SeriesPatch> patches;
+    if (sub->patches &&
+        RenderEngine::patchLiveBars(sub->seriesTypes, sub->source, bars, sub->rendered, patches, &bounds)) {
+        trace.genEndUs = monotonicMicros();
+        if (!patches.empty()) sendPatches(sub, patches, trace);
+        return;
+    }
+    auto cmds = RenderEngine::renderLiveBars(sub->seriesTypes, sub->source, bars, sub->rendered, &bounds);
+    trace.genEndUs = monotonicMicros();
+    sendDrawCommands(sub, cmds, trace);
+}
+
+// ─── Relay mode ──────────────────────────────────────────────────────────
+
+void WebSocketSession::attachRelay(const SubscriptionPtr& sub) {
+    RelayChannelKey key;
+    key.source      = sub->source;
+    key.seriesTypes = sub->seriesTypes;
+    key.patch       = sub->patches;
+    key.fromT       = sub->fromT;
+    key.toT         = sub->toT;
+
+    // Frames still in flight from a previous channel (before a viewport
+    // change) must not be applied on top of the new one
+    const uint64_t generation = ++sub->relayGeneration;
+
+    // Called on the relay thread; hop onto this session's thread
+    std::weak_ptr<WebSocketSession> weakSelf = shared_from_this();
+    std::weak_ptr<Subscription>     weakSub  = sub;
+    sub->relayToken = RelayUpstream::instance().attach(key,
+        [weakSelf, weakSub, generation](const RelayFramePtr& frame) {
+            auto session = weakSelf.lock();
+            if (!session) return;
+            net::post(session->ioc_, [weakSelf, weakSub, generation, frame] {
+                auto self = weakSelf.lock();
+                auto s    = weakSub.lock();
+                if (self && s && s->relayGeneration == generation) self->relayFrame(s, frame);
+            });
+        });
+}
+
+void WebSocketSession::relayFrame(const SubscriptionPtr& sub, const RelayFramePtr& frame) {
+    auto it = subscriptions_.find(sub->id);
+    if (it == subscriptions_.end() || it->second != sub) return;
+
+    if (frame->kind == RelayFrame::Kind::Other) {
+        send(Protocol::wrapBody(frame->body, sub->id));
+        return;
+    }
+    // A client that missed a patch is only repaired by a full frame
+    if (sub->relayStale && frame->kind != RelayFrame::Kind::Full) return;
+    if (sub->queued >= kMaxRelayQueued) {
+        sub->relayStale = true;  // onWrite replays the relay cache once drained
+        return;
+    }
+    sub->relayStale = false;
+
+    // Nothing is generated here; only the envelope is rewritten
+    FrameTrace trace;
+    trace.genStartUs = monotonicMicros();
+    trace.genEndUs   = trace.genStartUs;
+    const uint64_t seq = sub->sequenced ? sub->nextSeq++ : 0;
+    sendTraced(sub, Protocol::wrapBody(frame->body, sub->id, seq), seq, trace);
+}
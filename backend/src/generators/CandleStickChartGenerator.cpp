@@ -12,28 +12,52 @@ using ChartingApp::DrawCommand;
 DrawCommand CandleStickChartGenerator::generate(
     const std::string& seriesId,
     const std::vector<OhlcPoint>& data
+) {
+    return generateTail(seriesId, data, boundsFor(data), 0);
+}
+
+SeriesBounds CandleStickChartGenerator::boundsFor(const std::vector<OhlcPoint>& data) {
+    SeriesBounds b;
+    if (data.empty()) return b;
+
+    // Compute ranges
+    b.minT = data.front().timestamp; b.maxT = b.minT;
+    b.minP = data.front().low;       b.maxP = data.front().high;
+    for (auto& bar : data) {
+        b.minT = std::min(b.minT, bar.timestamp);
+        b.maxT = std::max(b.maxT, bar.timestamp);
+        b.minP = std::min(b.minP, bar.low);
+        b.maxP = std::max(b.maxP, bar.high);
+    }
+    return b;
+}
+
+DrawCommand CandleStickChartGenerator::generateTail(
+    const std::string& seriesId,
+    const std::vector<OhlcPoint>& data,
+    const SeriesBounds& bounds,
+    size_t fromIndex
 ) {
     DrawCommand cmd;
     cmd.type     = "drawSeries";
     cmd.pane     = "main";
     cmd.seriesId = seriesId;
+    cmd.style.type      = "candlestick";
     cmd.style.color     = "#00ff00";
     cmd.style.thickness = 1;
 
-    // Compute ranges
-    int64_t minT = data.front().timestamp, maxT = minT;
-    double  minP = data.front().low,       maxP = data.front().high;
-    for (auto& bar : data) {
-        minT = std::min(minT, bar.timestamp);
-        maxT = std::max(maxT, bar.timestamp);
-        minP = std::min(minP, bar.low);
-        maxP = std::max(maxP, bar.high);
+    const int64_t minT   = bounds.minT;
+    const double  minP   = bounds.minP;
+    const double  tRange = double(bounds.maxT - bounds.minT);
+    const double  pRange = bounds.maxP - bounds.minP;
+
+    if (fromIndex < data.size()) {
+        cmd.vertices.reserve((data.size() - fromIndex) * floatsPerBar());
     }
-    double tRange = double(maxT - minT);
-    double pRange = maxP - minP;
 
     // Pack wick & body as LINES
-    for (auto& bar : data) {
+    for (size_t i = fromIndex; i < data.size(); ++i) {
+        const auto& bar = data[i];
         float x = tRange > 0
             ? float(((bar.timestamp - minT) / tRange) * 2.0 - 1.0)
             : 0.0f;
@@ -13,37 +13,30 @@ using ChartingApp::DrawCommand;
 DrawCommand LineChartGenerator::generate(
     const std::string& seriesId,
     const std::vector<OhlcPoint>& data
+) {
+    // Raw (timestamp, close) pairs: no normalization range to compute
+    return generateTail(seriesId, data, SeriesBounds{}, 0);
+}
+
+DrawCommand LineChartGenerator::generateTail(
+    const std::string& seriesId,
+    const std::vector<OhlcPoint>& data,
+    const SeriesBounds& /*bounds*/,
+    size_t fromIndex
 ) {
     DrawCommand cmd;
     cmd.type     = "drawSeries";
     cmd.pane     = "main";
     cmd.seriesId = seriesId;
+    cmd.style.type      = "line";
     cmd.style.color     = "#00ff00";  // placeholder color
     cmd.style.thickness = 1;            // px
 
-    // Compute min/max for X (timestamps) and Y (close values)
-    auto [minIt, maxIt] = std::minmax_element(
-        data.begin(), data.end(),
-        [](auto const& a, auto const& b) {
-            return a.timestamp < b.timestamp;
-        }
-    );
-    int64_t minT = minIt->timestamp;
-    int64_t maxT = maxIt->timestamp;
-
-    auto [minVIt, maxVIt] = std::minmax_element(
-        data.begin(), data.end(),
-        [](auto const& a, auto const& b) {
-            return a.close < b.close;
-        }
-    );
-    double minV = minVIt->close;
-    double maxV = maxVIt->close;
-
-    cmd.vertices.reserve(data.size() * 2);
-    for (auto const& pt : data) {
-        cmd.vertices.push_back(static_cast<float>(pt.timestamp));
-        cmd.vertices.push_back(static_cast<float>(pt.close));
+    if (fromIndex >= data.size()) return cmd;
+    cmd.vertices.reserve((data.size() - fromIndex) * 2);
+    for (size_t i = fromIndex; i < data.size(); ++i) {
+        cmd.vertices.push_back(static_cast<float>(data[i].timestamp));
+        cmd.vertices.push_back(static_cast<float>(data[i].close));
     }
     return cmd;
 }
@@ -1,25 +1,23 @@
 // backend/src/main.cpp
 
 #include <cstdlib>              // std::getenv, std::atoi
-#include <fstream>              // std::ifstream
 #include <iostream>             // std::cout, std::cerr
+#include <memory>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
-#include "Protocol.hpp"         // your Protocol::processRequest
-#include "RenderEngine.hpp"     // for data loading if you extend server logic
+#include "WebSocketSession.hpp" // one client connection
+#include "SpscRing.hpp"         // tick ingest pipeline
+#include "TickAggregator.hpp"
+#include "TickIngestServer.hpp"
+#include "ShmPublisher.hpp"     // shared-memory transport for local readers
+#include "RelayUpstream.hpp"    // relay mode: live series from another chart_server
 
-// Boost.Beast / Asio
-#include <boost/beast/core.hpp>
-#include <boost/beast/websocket.hpp>
+// Boost.Asio
 #include <boost/asio/ip/tcp.hpp>
-#include <rapidjson/document.h> // for parsing subscribe/unsubscribe
 
-#include "rapidjson/stringbuffer.h"
-#include <rapidjson/writer.h>
-
-namespace beast     = boost::beast;
-namespace websocket = beast::websocket;
 namespace net       = boost::asio;
 using     tcp       = net::ip::tcp;
 
@@ -28,118 +26,14 @@ static std::string getEnvOr(const char* var, const char* def) {
     return val ? val : def;
 }
 
-// Handle one WebSocket session on its own thread
-void do_session(tcp::socket socket) {
-    try {
-        websocket::stream<tcp::socket> ws(std::move(socket));
-        ws.accept();  // complete handshake
-
-        for (;;) {
-            // Read a text frame
-            beast::flat_buffer buffer;
-            ws.read(buffer);
-            std::string msg = beast::buffers_to_string(buffer.data());
-
-            // Parse as JSON 
-            rapidjson::Document req;
-            req.Parse(msg.c_str());
-            if (req.HasParseError() || !req.IsObject() ||
-                !req.HasMember("type") || !req["type"].IsString()) {
-                const std::string err = R"({"type":"error","message":"Invalid JSON request"})";
-                ws.write(net::buffer(err)); 
-                continue;
-            }
-
-            std::string reqType = req["type"].GetString();
-            if (reqType == "subscribe") {
-                if (reqType == "subscribe") {
-                // Collect requested series types (string or array)
-                std::vector<std::string> types;
-                auto& alloc = req.GetAllocator();
-
-                if (req.HasMember("seriesTypes") && req["seriesTypes"].IsArray()) {
-                    for (auto& v : req["seriesTypes"].GetArray()) {
-                        if (v.IsString())
-                            types.emplace_back(v.GetString());
-                    }
-                } else if (req.HasMember("seriesType") && req["seriesType"].IsString()) {
-                    types.emplace_back(req["seriesType"].GetString());
-                } else {
-                    const std::string err = R"({"type":"error","message":"Invalid JSON request"})";
-                    ws.write(net::buffer(err)); 
-                    continue;
-                }
-
-                // Load the same JSON array from disk once
-                std::string dataFile = getEnvOr("DATA_FILE_PATH", "data/sample_data.json");
-                std::ifstream ifs(dataFile);
-                if (!ifs.is_open()) {
-                    const std::string err = R"({"type":"error","message":"Invalid JSON request"})";
-                    ws.write(net::buffer(err)); 
-                    continue;
-                }
-                std::string jsonArray((std::istreambuf_iterator<char>(ifs)),
-                                      std::istreambuf_iterator<char>());
-
-                // For each requested series, generate commands and collect
-                std::vector<DrawCommand> allCmds;
-                for (auto& st : types) {
-                    // call the real static overload you implemented
-                    auto cmds = RenderEngine::generateIncrementalDrawCommands(st, jsonArray, 0);
-                    allCmds.insert(allCmds.end(), cmds.begin(), cmds.end());
-                }
-
-                // Build one batch envelope with ALL commands
-                rapidjson::Document resp(rapidjson::kObjectType);
-                auto& ralloc = resp.GetAllocator();
-                resp.AddMember("type", "drawCommands", ralloc);
-
-                rapidjson::Value arr(rapidjson::kArrayType);
-                for (auto& cmd : allCmds) {
-                    rapidjson::Value obj(rapidjson::kObjectType);
-                    obj.AddMember("type", rapidjson::Value(cmd.type.c_str(), ralloc), ralloc);
-                    obj.AddMember("label", rapidjson::Value(cmd.label.c_str(), ralloc), ralloc);
-                    obj.AddMember("pane", rapidjson::Value(cmd.pane.c_str(), ralloc), ralloc);
-                    obj.AddMember("seriesId", rapidjson::Value(cmd.seriesId.c_str(), ralloc), ralloc);
-
-                    // vertices
-                    rapidjson::Value verts(rapidjson::kArrayType);
-                    for (float v : cmd.vertices) verts.PushBack(v, ralloc);
-                    obj.AddMember("vertices", verts, ralloc);
-
-                    // style
-                    rapidjson::Value styleObj(rapidjson::kObjectType);
-                    styleObj.AddMember("color", rapidjson::Value(cmd.style.color.c_str(), ralloc), ralloc);
-                    styleObj.AddMember("altColor", rapidjson::Value(cmd.style.altColor.c_str(), ralloc), ralloc);
-                    styleObj.AddMember("wickColor", rapidjson::Value(cmd.style.wickColor.c_str(), ralloc), ralloc);
-                    styleObj.AddMember("thickness", cmd.style.thickness, ralloc);
-                    obj.AddMember("style", styleObj, ralloc);
-
-                    arr.PushBack(obj, ralloc);
-                }
-                resp.AddMember("commands", arr, ralloc);
-
-                rapidjson::StringBuffer sb;
-                rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-                resp.Accept(writer);
-                boost::system::error_code ec;
-                ws.write(net::buffer(sb.GetString(), sb.GetSize()), ec);
-                if(ec)
-    throw boost::system::system_error{ec};
-            } else if (reqType == "unsubscribe") {
-                // Graceful close
-                ws.close(websocket::close_code::normal);
-                break;
-
-            } else {
-                const std::string err = R"({"type":"error","message":"Invalid JSON request"})";
-                ws.write(net::buffer(err)); 
-            }
-        }
-      }
-    } catch (std::exception const& e) {
-        std::cerr << "[WebSocket] Session error: " << e.what() << "\n";
+static std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(item);
     }
+    return out;
 }
 
 int main() {
@@ -149,6 +43,59 @@ int main() {
             std::atoi(getEnvOr("BACKEND_PORT", "9001").c_str())
         );
 
+        // Optional tick ingest: raw ticks -> SPSC ring -> bar aggregator -> SeriesStore
+        std::unique_ptr<SpscRing<Tick>>   tickRing;
+        std::unique_ptr<TickAggregator>   tickAggregator;
+        std::unique_ptr<TickIngestServer> tickIngest;
+
+        TickIngestConfig ingestCfg;
+        ingestCfg.unixPath = getEnvOr("TICK_INGEST_SOCKET", "");
+        ingestCfg.tcpPort  = static_cast<unsigned short>(
+            std::atoi(getEnvOr("TICK_INGEST_PORT", "0").c_str())
+        );
+        if (!ingestCfg.unixPath.empty() || ingestCfg.tcpPort != 0) {
+            std::string seriesId = getEnvOr("TICK_SERIES_ID", "ticks");
+            int64_t intervalMs   = std::atoll(getEnvOr("TICK_BAR_INTERVAL_MS", "60000").c_str());
+            size_t ringCapacity  = std::strtoull(getEnvOr("TICK_RING_CAPACITY", "1048576").c_str(), nullptr, 10);
+
+            tickRing       = std::make_unique<SpscRing<Tick>>(ringCapacity);
+            tickAggregator = std::make_unique<TickAggregator>(*tickRing, seriesId, intervalMs);
+            tickIngest     = std::make_unique<TickIngestServer>(*tickRing, ingestCfg);
+            tickAggregator->start();
+            tickIngest->start();
+            std::cout << "[main] Tick ingest publishing " << intervalMs
+                      << " ms bars as series '" << seriesId << "'\n";
+        }
+
+        // Optional shared-memory transport: live series -> binary frames -> POSIX shm ring
+        std::unique_ptr<ShmPublisher> shmPublisher;
+        std::string shmName = getEnvOr("SHM_RING_NAME", "");
+        if (!shmName.empty()) {
+            ShmPublisherConfig shmCfg;
+            shmCfg.name        = shmName;
+            shmCfg.slotCount   = static_cast<uint32_t>(std::strtoul(getEnvOr("SHM_RING_SLOTS", "64").c_str(), nullptr, 10));
+            shmCfg.slotBytes   = static_cast<uint32_t>(std::strtoul(getEnvOr("SHM_RING_SLOT_BYTES", "262144").c_str(), nullptr, 10));
+            shmCfg.sources     = splitList(getEnvOr("SHM_RING_SOURCES", getEnvOr("TICK_SERIES_ID", "ticks").c_str()));
+            shmCfg.seriesTypes = splitList(getEnvOr("SHM_RING_SERIES_TYPES", "candlestick"));
+            shmCfg.maxBars     = std::strtoul(getEnvOr("SHM_RING_MAX_BARS", "4096").c_str(), nullptr, 10);
+
+            shmPublisher = std::make_unique<ShmPublisher>(shmCfg);
+            if (!shmPublisher->start()) shmPublisher.reset();
+        }
+
+        // Optional relay mode: serve live subscriptions from an upstream chart_server
+        std::string upstream = getEnvOr("RELAY_UPSTREAM", "");
+        if (!upstream.empty()) {
+            auto colon = upstream.rfind(':');
+            if (colon == std::string::npos) {
+                std::cerr << "[main] RELAY_UPSTREAM must be host:port\n";
+                return EXIT_FAILURE;
+            }
+            RelayUpstream::instance().start(
+                upstream.substr(0, colon),
+                static_cast<unsigned short>(std::atoi(upstream.c_str() + colon + 1)));
+        }
+
         net::io_context ioc{1};
         auto address = net::ip::make_address("0.0.0.0");
         tcp::acceptor acceptor{ioc, {address, port}};
@@ -157,10 +104,10 @@ int main() {
 
         // Accept loop
         for (;;) {
-            tcp::socket socket{ioc};
-            acceptor.accept(socket);
+            auto session = std::make_shared<WebSocketSession>();
+            acceptor.accept(session->socket());
             // Detach each session on its own thread
-            std::thread(&do_session, std::move(socket)).detach();
+            std::thread([session] { session->run(); }).detach();
         }
 
     } catch (std::exception const& e) {
@@ -0,0 +1,249 @@
+// PngEncoder.cpp
+// PNG container, zlib stream and fixed-Huffman deflate, all in one place
+
+#include "thumbnails/PngEncoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// ─── Checksums ───────────────────────────────────────────────────────────
+
+const std::array<uint32_t, 256>& crcTable() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) crc = crcTable()[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+uint32_t adler32(const std::vector<uint8_t>& data) {
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : data) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+// ─── Deflate (RFC 1951, fixed Huffman block) ─────────────────────────────
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    // Plain value, LSB first (header bits and extra bits)
+    void bits(uint32_t value, int count) {
+        acc_ |= value << used_;
+        used_ += count;
+        while (used_ >= 8) {
+            out_.push_back(uint8_t(acc_));
+            acc_ >>= 8;
+            used_ -= 8;
+        }
+    }
+
+    // Huffman code, which deflate stores MSB first
+    void code(uint32_t code, int len) {
+        uint32_t rev = 0;
+        for (int i = 0; i < len; ++i) rev |= ((code >> i) & 1u) << (len - 1 - i);
+        bits(rev, len);
+    }
+
+    void flush() {
+        if (used_ > 0) out_.push_back(uint8_t(acc_));
+        acc_ = 0;
+        used_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint32_t              acc_  = 0;
+    int                   used_ = 0;
+};
+
+constexpr uint16_t kLenBase[29]  = {3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258};
+constexpr uint8_t  kLenExtra[29] = {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0};
+constexpr uint16_t kDistBase[30] = {1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,
+                                    1025,1537,2049,3073,4097,6145,8193,12289,16385,24577};
+constexpr uint8_t  kDistExtra[30] = {0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13};
+
+void writeLitLen(BitWriter& bw, int sym) {
+    if (sym < 144)      bw.code(0x30 + sym, 8);
+    else if (sym < 256) bw.code(0x190 + (sym - 144), 9);
+    else if (sym < 280) bw.code(sym - 256, 7);
+    else                bw.code(0xC0 + (sym - 280), 8);
+}
+
+void writeMatch(BitWriter& bw, int length, int distance) {
+    int li = 28;
+    while (kLenBase[li] > length) --li;
+    writeLitLen(bw, 257 + li);
+    if (kLenExtra[li]) bw.bits(length - kLenBase[li], kLenExtra[li]);
+
+    int di = 29;
+    while (kDistBase[di] > distance) --di;
+    bw.code(di, 5);
+    if (kDistExtra[di]) bw.bits(distance - kDistBase[di], kDistExtra[di]);
+}
+
+std::vector<uint8_t> deflate(const std::vector<uint8_t>& in) {
+    constexpr int kWindow   = 32768;
+    constexpr int kMinMatch = 3;
+    constexpr int kMaxMatch = 258;
+    constexpr int kMaxChain = 32;
+
+    std::vector<uint8_t> out;
+    BitWriter bw(out);
+    bw.bits(1, 1);  // BFINAL
+    bw.bits(1, 2);  // BTYPE = fixed Huffman
+
+    // Hash chains over 3-byte prefixes
+    const int n = int(in.size());
+    std::vector<int> head(1 << 15, -1), prev(n, -1);
+    auto hash = [&](int i) {
+        return ((in[i] << 10) ^ (in[i + 1] << 5) ^ in[i + 2]) & 0x7FFF;
+    };
+    auto insert = [&](int i) {
+        if (i + kMinMatch > n) return;
+        int h = hash(i);
+        prev[i] = head[h];
+        head[h] = i;
+    };
+
+    int i = 0;
+    while (i < n) {
+        int bestLen = 0, bestDist = 0;
+        if (i + kMinMatch <= n) {
+            int cand = head[hash(i)];
+            for (int chain = 0; cand >= 0 && i - cand <= kWindow && chain < kMaxChain; ++chain) {
+                int len = 0, maxLen = std::min(kMaxMatch, n - i);
+                while (len < maxLen && in[cand + len] == in[i + len]) ++len;
+                if (len > bestLen) {
+                    bestLen = len;
+                    bestDist = i - cand;
+                    if (len == maxLen) break;
+                }
+                cand = prev[cand];
+            }
+        }
+
+        if (bestLen >= kMinMatch) {
+            writeMatch(bw, bestLen, bestDist);
+            for (int k = 0; k < bestLen; ++k) insert(i + k);
+            i += bestLen;
+        } else {
+            writeLitLen(bw, in[i]);
+            insert(i);
+            ++i;
+        }
+    }
+    writeLitLen(bw, 256);  // end of block
+    bw.flush();
+    return out;
+}
+
+// ─── PNG container ───────────────────────────────────────────────────────
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(uint8_t(v >> 24));
+    out.push_back(uint8_t(v >> 16));
+    out.push_back(uint8_t(v >> 8));
+    out.push_back(uint8_t(v));
+}
+
+void chunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& data) {
+    put32(out, uint32_t(data.size()));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put32(out, crc32(out.data() + start, out.size() - start));
+}
+
+} // namespace
+
+std::vector<uint8_t> PngEncoder::encode(const RgbaImage& image) {
+    const size_t pixelCount = size_t(image.width) * image.height;
+
+    // Try to build a palette; give up past 256 colors
+    std::unordered_map<uint32_t, uint8_t> index;
+    std::vector<uint32_t> palette;
+    std::vector<uint8_t> indices(pixelCount);
+    bool indexed = true;
+    for (size_t p = 0; p < pixelCount && indexed; ++p) {
+        const uint8_t* px = &image.pixels[p * 4];
+        uint32_t key = (uint32_t(px[0]) << 24) | (px[1] << 16) | (px[2] << 8) | px[3];
+        auto it = index.find(key);
+        if (it == index.end()) {
+            if (palette.size() == 256) { indexed = false; break; }
+            it = index.emplace(key, uint8_t(palette.size())).first;
+            palette.push_back(key);
+        }
+        indices[p] = it->second;
+    }
+
+    // Scanlines, each prefixed with filter type 0 (None)
+    const size_t bpp = indexed ? 1 : 4;
+    std::vector<uint8_t> raw;
+    raw.reserve(image.height * (1 + image.width * bpp));
+    for (int y = 0; y < image.height; ++y) {
+        raw.push_back(0);
+        if (indexed) {
+            const uint8_t* row = &indices[size_t(y) * image.width];
+            raw.insert(raw.end(), row, row + image.width);
+        } else {
+            const uint8_t* row = &image.pixels[size_t(y) * image.width * 4];
+            raw.insert(raw.end(), row, row + image.width * 4);
+        }
+    }
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    std::vector<uint8_t> ihdr;
+    put32(ihdr, uint32_t(image.width));
+    put32(ihdr, uint32_t(image.height));
+    ihdr.push_back(8);                  // bit depth
+    ihdr.push_back(indexed ? 3 : 6);    // color type: palette / RGBA
+    ihdr.push_back(0);                  // compression
+    ihdr.push_back(0);                  // filter
+    ihdr.push_back(0);                  // interlace
+    chunk(png, "IHDR", ihdr);
+
+    if (indexed) {
+        std::vector<uint8_t> plte, trns;
+        bool anyTransparent = false;
+        for (uint32_t c : palette) {
+            plte.push_back(uint8_t(c >> 24));
+            plte.push_back(uint8_t(c >> 16));
+            plte.push_back(uint8_t(c >> 8));
+            trns.push_back(uint8_t(c));
+            anyTransparent |= uint8_t(c) != 255;
+        }
+        chunk(png, "PLTE", plte);
+        if (anyTransparent) chunk(png, "tRNS", trns);
+    }
+
+    // zlib stream: CMF/FLG (deflate, 32K window, no dict), data, Adler-32
+    std::vector<uint8_t> zdata = {0x78, 0x01};
+    std::vector<uint8_t> body = deflate(raw);
+    zdata.insert(zdata.end(), body.begin(), body.end());
+    put32(zdata, adler32(raw));
+    chunk(png, "IDAT", zdata);
+
+    chunk(png, "IEND", {});
+    return png;
+}
@@ -0,0 +1,177 @@
+// ThumbnailCache.cpp
+
+#include "thumbnails/ThumbnailCache.hpp"
+#include "thumbnails/PngEncoder.hpp"
+#include "RenderEngine.hpp"
+#include "SeriesStore.hpp"
+
+#include <algorithm>
+
+namespace {
+// A watchlist page at a couple of sizes fits many times over; a client
+// cycling through sizes only churns the tail
+constexpr size_t kMaxEntries = 8192;
+constexpr size_t kMaxBytes   = 32u << 20;
+
+// Renders waiting for a worker, across all sessions; a batch that would
+// overflow it fails its misses instead of queuing them
+constexpr size_t kMaxQueuedRenders = 4096;
+} // namespace
+
+// Misses of one render() call; the worker finishing the last one completes it
+struct ThumbnailCache::Batch {
+    std::vector<ThumbnailRequest> requests;
+    std::vector<Thumbnail>        results;
+    std::vector<size_t>           missing;
+    std::atomic<size_t>           remaining{0};
+    Done                          done;
+};
+
+ThumbnailCache& ThumbnailCache::instance() {
+    static ThumbnailCache cache;
+    return cache;
+}
+
+ThumbnailCache::~ThumbnailCache() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        stopping_ = true;
+    }
+    poolWake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+std::string ThumbnailCache::keyFor(const ThumbnailRequest& req) {
+    const auto& o = req.options;
+    return req.source + '\x1f' + req.seriesType + '\x1f' +
+           std::to_string(o.width) + 'x' + std::to_string(o.height) + '\x1f' +
+           std::to_string(o.padding) + '\x1f' + std::to_string(o.background);
+}
+
+Thumbnail ThumbnailCache::renderOne(const ThumbnailRequest& req) {
+    Thumbnail out;
+    out.source = req.source;
+
+    auto bars = SeriesStore::instance().snapshot(req.source, &out.version);
+    if (bars.empty()) {
+        out.error = "Unknown or empty series";
+        return out;
+    }
+    auto cmds = RenderEngine::generateBarDrawCommands(req.seriesType, req.source, bars);
+    if (cmds.empty()) {
+        out.error = "Unknown series type";
+        return out;
+    }
+    RgbaImage img = ThumbnailRasterizer::rasterize(req.seriesType, cmds, req.options);
+    out.png = std::make_shared<const std::vector<uint8_t>>(PngEncoder::encode(img));
+    return out;
+}
+
+void ThumbnailCache::render(std::vector<ThumbnailRequest> requests, Done done) {
+    auto batch = std::make_shared<Batch>();
+    batch->results.resize(requests.size());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const auto& req = requests[i];
+            uint64_t current = SeriesStore::instance().version(req.source);
+            auto it = entries_.find(keyFor(req));
+            if (current != 0 && it != entries_.end() && it->second.version == current) {
+                batch->results[i] = Thumbnail{req.source, current, it->second.png, {}};
+                lru_.splice(lru_.begin(), lru_, it->second.lru);
+            } else {
+                batch->missing.push_back(i);
+            }
+        }
+    }
+    hits_.fetch_add(requests.size() - batch->missing.size(), std::memory_order_relaxed);
+    misses_.fetch_add(batch->missing.size(), std::memory_order_relaxed);
+    if (batch->missing.empty()) {
+        done(std::move(batch->results));
+        return;
+    }
+
+    batch->requests  = std::move(requests);
+    batch->done      = std::move(done);
+    batch->remaining = batch->missing.size();
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(batch->missing.size());
+    for (size_t i : batch->missing) {
+        tasks.push_back([this, batch, i] {
+            const ThumbnailRequest& req = batch->requests[i];
+            Thumbnail& r = batch->results[i];
+            r = renderOne(req);
+            if (r.png) store(keyFor(req), r);
+            if (batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                batch->done(std::move(batch->results));
+            }
+        });
+    }
+    if (!enqueue(std::move(tasks))) {
+        for (size_t i : batch->missing) {
+            batch->results[i].source = batch->requests[i].source;
+            batch->results[i].error  = "Thumbnail renderer busy";
+        }
+        batch->done(std::move(batch->results));
+    }
+}
+
+void ThumbnailCache::store(const std::string& key, const Thumbnail& t) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        lru_.push_front(key);
+        it = entries_.emplace(key, Entry{0, nullptr, lru_.begin()}).first;
+    } else {
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+    }
+    Entry& e = it->second;
+    if (e.png && t.version < e.version) return;  // a newer render landed first
+    if (e.png) bytes_ -= e.png->size();
+    e.version = t.version;
+    e.png     = t.png;
+    bytes_   += e.png->size();
+    evict();
+}
+
+// Drops least recently used entries until both limits hold; mutex_ held
+void ThumbnailCache::evict() {
+    while (!lru_.empty() && (entries_.size() > kMaxEntries || bytes_ > kMaxBytes)) {
+        auto it = entries_.find(lru_.back());
+        if (it->second.png) bytes_ -= it->second.png->size();
+        entries_.erase(it);
+        lru_.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// ─── Worker pool ─────────────────────────────────────────────────────────
+
+bool ThumbnailCache::enqueue(std::vector<std::function<void()>> tasks) {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        if (tasks_.size() + tasks.size() > kMaxQueuedRenders) return false;
+        if (workers_.empty()) {
+            const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned t = 0; t < n; ++t) workers_.emplace_back(&ThumbnailCache::workerLoop, this);
+        }
+        for (auto& task : tasks) tasks_.push_back(std::move(task));
+    }
+    poolWake_.notify_all();
+    return true;
+}
+
+void ThumbnailCache::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(poolMutex_);
+            poolWake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_) return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
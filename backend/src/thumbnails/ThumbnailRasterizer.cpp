@@ -0,0 +1,135 @@
+// ThumbnailRasterizer.cpp
+// CPU line rasterizer that turns DrawCommands into small RGBA images
+
+#include "thumbnails/ThumbnailRasterizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+struct Rgba { uint8_t r, g, b, a; };
+
+// "#rrggbb" or "#rgb"; anything else yields `fallback`
+Rgba parseColor(const std::string& hex, Rgba fallback) {
+    if (hex.empty() || hex[0] != '#') return fallback;
+    char* end = nullptr;
+    unsigned long v = std::strtoul(hex.c_str() + 1, &end, 16);
+    if (*end != '\0') return fallback;
+    if (hex.size() == 7) {
+        return { uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v), 255 };
+    }
+    if (hex.size() == 4) {
+        return { uint8_t(((v >> 8) & 0xF) * 17), uint8_t(((v >> 4) & 0xF) * 17),
+                 uint8_t((v & 0xF) * 17), 255 };
+    }
+    return fallback;
+}
+
+class Canvas {
+public:
+    explicit Canvas(RgbaImage& img) : img_(img) {}
+
+    // Square brush of `size` px centred on (x, y)
+    void stamp(int x, int y, int size, Rgba c) {
+        const int lo = -(size - 1) / 2, hi = size / 2;
+        for (int dy = lo; dy <= hi; ++dy) {
+            for (int dx = lo; dx <= hi; ++dx) put(x + dx, y + dy, c);
+        }
+    }
+
+    // Bresenham; thickness comes from the brush
+    void line(int x0, int y0, int x1, int y1, int size, Rgba c) {
+        int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+        int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy;
+        for (;;) {
+            stamp(x0, y0, size, c);
+            if (x0 == x1 && y0 == y1) break;
+            int e2 = 2 * err;
+            if (e2 >= dy) { err += dy; x0 += sx; }
+            if (e2 <= dx) { err += dx; y0 += sy; }
+        }
+    }
+
+private:
+    void put(int x, int y, Rgba c) {
+        if (x < 0 || y < 0 || x >= img_.width || y >= img_.height) return;
+        uint8_t* p = &img_.pixels[(size_t(y) * img_.width + x) * 4];
+        p[0] = c.r; p[1] = c.g; p[2] = c.b; p[3] = c.a;
+    }
+
+    RgbaImage& img_;
+};
+
+} // namespace
+
+RgbaImage ThumbnailRasterizer::rasterize(
+    const std::string& seriesType,
+    const std::vector<DrawCommand>& commands,
+    const ThumbnailOptions& options
+) {
+    RgbaImage img;
+    img.width  = std::max(1, options.width);
+    img.height = std::max(1, options.height);
+    img.pixels.resize(size_t(img.width) * img.height * 4);
+
+    const Rgba bg{ uint8_t(options.background >> 24), uint8_t(options.background >> 16),
+                   uint8_t(options.background >> 8),  uint8_t(options.background) };
+    for (size_t i = 0; i < img.pixels.size(); i += 4) {
+        img.pixels[i] = bg.r; img.pixels[i + 1] = bg.g; img.pixels[i + 2] = bg.b; img.pixels[i + 3] = bg.a;
+    }
+
+    // Fit every command's vertices into the padded image
+    double minX = std::numeric_limits<double>::max(), maxX = std::numeric_limits<double>::lowest();
+    double minY = minX, maxY = maxX;
+    for (const auto& cmd : commands) {
+        for (size_t i = 0; i + 1 < cmd.vertices.size(); i += 2) {
+            minX = std::min(minX, double(cmd.vertices[i]));
+            maxX = std::max(maxX, double(cmd.vertices[i]));
+            minY = std::min(minY, double(cmd.vertices[i + 1]));
+            maxY = std::max(maxY, double(cmd.vertices[i + 1]));
+        }
+    }
+    if (minX > maxX) return img;  // nothing to draw
+
+    const int pad = std::clamp(options.padding, 0, std::min(img.width, img.height) / 2);
+    const double spanW = std::max(0, img.width  - 1 - 2 * pad);
+    const double spanH = std::max(0, img.height - 1 - 2 * pad);
+    const double xRange = maxX - minX, yRange = maxY - minY;
+    auto toPx = [&](float x) {
+        return int(std::lround(pad + (xRange > 0 ? (x - minX) / xRange : 0.5) * spanW));
+    };
+    auto toPy = [&](float y) {
+        return int(std::lround(pad + (yRange > 0 ? (maxY - y) / yRange : 0.5) * spanH));
+    };
+
+    const bool segments = (seriesType == "candlestick");
+    Canvas canvas(img);
+    for (const auto& cmd : commands) {
+        const auto& v = cmd.vertices;
+        const Rgba fallback{0, 0, 0, 255};
+        const Rgba color = segments && !cmd.style.wickColor.empty()
+            ? parseColor(cmd.style.wickColor, fallback)
+            : parseColor(cmd.style.color, fallback);
+        const int brush = std::max(1, int(std::lround(cmd.style.thickness)));
+
+        const size_t n = v.size() / 2;
+        if (segments) {
+            for (size_t i = 0; i + 1 < n; i += 2) {
+                canvas.line(toPx(v[2 * i]), toPy(v[2 * i + 1]),
+                            toPx(v[2 * i + 2]), toPy(v[2 * i + 3]), brush, color);
+            }
+        } else if (n == 1) {
+            canvas.stamp(toPx(v[0]), toPy(v[1]), brush, color);
+        } else {
+            for (size_t i = 0; i + 1 < n; ++i) {
+                canvas.line(toPx(v[2 * i]), toPy(v[2 * i + 1]),
+                            toPx(v[2 * i + 2]), toPy(v[2 * i + 3]), brush, color);
+            }
+        }
+    }
+    return img;
+}
@@ -0,0 +1,97 @@
+// backend/src/tools/ShmTail.cpp
+// Follows the chart_server shared-memory frame ring and reports throughput,
+// publish-to-read latency and overruns once a second. Doubles as a minimal
+// example of a local consumer.
+//
+//   shm_tail [name] [--from-start] [--decode] [--slow US]
+//
+// name defaults to SHM_RING_NAME or "/chart_frames". --decode parses every
+// frame and prints a one-line summary of it; --slow sleeps after each frame to
+// simulate a lagging reader.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryFrame.hpp"
+#include "ShmRing.hpp"
+#include "Tracing.hpp"
+
+static void printFrame(const ShmFrameInfo& info, const BinaryFrame& frame) {
+    size_t vertices = 0;
+    for (const auto& c : frame.commands) vertices += c.vertices.size() / 2;
+    std::cout << "#" << info.seq << " '" << frame.source << "' v" << frame.version
+              << ": " << frame.commands.size() << " commands, " << vertices << " vertices\n";
+}
+
+int main(int argc, char** argv) {
+    const char* env = std::getenv("SHM_RING_NAME");
+    std::string name = env ? env : "/chart_frames";
+    bool fromStart = false, decode = false;
+    int  slowUs = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--from-start")                 fromStart = true;
+        else if (a == "--decode")                decode = true;
+        else if (a == "--slow" && i + 1 < argc)  slowUs = std::atoi(argv[++i]);
+        else if (!a.empty() && a[0] != '-')      name = a;
+        else {
+            std::cerr << "usage: shm_tail [name] [--from-start] [--decode] [--slow US]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    ShmRingReader reader;
+    std::string error;
+    if (!reader.open(name, fromStart, error)) {
+        std::cerr << "[shm_tail] " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "[shm_tail] Following '" << name << "'\n";
+
+    std::vector<uint8_t> buf;
+    BinaryFrame          frame;
+    ShmFrameInfo         info;
+    LatencyHistogram     latency;
+    uint64_t frames = 0, bytes = 0, bad = 0, lastOverruns = 0;
+    unsigned idleSpins = 0;
+    auto lastReport = std::chrono::steady_clock::now();
+
+    for (;;) {
+        if (reader.next(buf, &info)) {
+            latency.record(monotonicMicros() - info.publishUs);
+            ++frames;
+            bytes += buf.size();
+            idleSpins = 0;
+            if (decode) {
+                if (decodeBinaryFrame(buf.data(), buf.size(), frame)) printFrame(info, frame);
+                else ++bad;
+            }
+            if (slowUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(slowUs));
+        } else if (++idleSpins < 64) {
+            std::this_thread::yield();
+        } else {
+            // Polling costs nothing on the server side, only our own core
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(1)) {
+            const LatencySummary s = latency.summary();
+            std::cout << "[shm_tail] " << frames << " frames, " << bytes / 1024 << " KiB"
+                      << " | latency us p50 " << s.p50 << " p99 " << s.p99 << " max " << s.max
+                      << " | overruns +" << (reader.overruns() - lastOverruns)
+                      << " (total " << reader.overruns() << ")";
+            if (bad) std::cout << " | " << bad << " undecodable";
+            std::cout << std::endl;
+            frames = bytes = 0;
+            lastOverruns = reader.overruns();
+            latency = LatencyHistogram{};
+            lastReport = now;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+// backend/src/tools/TickReplay.cpp
+// Replays ticks from a local CSV file (or a synthetic random walk) into the
+// chart_server tick ingest socket as fast as the socket accepts them.
+//
+//   tick_replay <ticks.csv | --synthetic N> [--port P | --unix PATH] [--loops K]
+//
+// CSV lines are "timestamp,price,size"; blank lines and lines starting with '#'
+// are skipped. --loops resends the same buffer, so timestamps repeat and the
+// server only aggregates the first pass; use it to measure ingest rate.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/write.hpp>
+
+#include "Tick.hpp"
+
+namespace net = boost::asio;
+
+static std::vector<Tick> loadCsv(const std::string& path) {
+    std::vector<Tick> out;
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        std::cerr << "[tick_replay] Cannot open " << path << std::endl;
+        return out;
+    }
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        char* end = nullptr;
+        Tick t;
+        t.timestamp = std::strtoll(line.c_str(), &end, 10);
+        if (*end != ',') continue;
+        t.price = std::strtod(end + 1, &end);
+        if (*end != ',') continue;
+        t.size = std::strtod(end + 1, &end);
+        out.push_back(t);
+    }
+    return out;
+}
+
+static std::vector<Tick> synthesize(size_t count) {
+    std::vector<Tick> out;
+    out.reserve(count);
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 0.05);
+    std::uniform_real_distribution<double> size(1.0, 500.0);
+    int64_t ts = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    double price = 100.0;
+    for (size_t i = 0; i < count; ++i) {
+        price += step(rng);
+        out.push_back(Tick{ts + int64_t(i / 10), price, size(rng)});  // ~10 ticks per ms
+    }
+    return out;
+}
+
+template <typename Socket>
+static void replay(Socket& socket, const std::vector<unsigned char>& wire, int loops, size_t tickCount) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; ++i) {
+        net::write(socket, net::buffer(wire));
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    uint64_t sent = uint64_t(tickCount) * loops;
+    std::cout << "[tick_replay] Sent " << sent << " ticks in " << secs << " s ("
+              << (secs > 0 ? uint64_t(sent / secs) : 0) << " ticks/s)\n";
+}
+
+int main(int argc, char** argv) {
+    std::string file, unixPath;
+    size_t synthetic = 0;
+    unsigned short port = 9101;
+    int loops = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--synthetic" && i + 1 < argc)  synthetic = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--port" && i + 1 < argc)  port = static_cast<unsigned short>(std::atoi(argv[++i]));
+        else if (a == "--unix" && i + 1 < argc)  unixPath = argv[++i];
+        else if (a == "--loops" && i + 1 < argc) loops = std::max(1, std::atoi(argv[++i]));
+        else file = a;
+    }
+    if (file.empty() && synthetic == 0) {
+        std::cerr << "usage: tick_replay <ticks.csv | --synthetic N> [--port P | --unix PATH] [--loops K]\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Tick> ticks = synthetic ? synthesize(synthetic) : loadCsv(file);
+    if (ticks.empty()) {
+        std::cerr << "[tick_replay] No ticks to send" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Encode once up front so the send loop measures the server, not us
+    std::vector<unsigned char> wire(ticks.size() * kTickWireSize);
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        encodeTick(ticks[i], wire.data() + i * kTickWireSize);
+    }
+
+    try {
+        net::io_context ioc{1};
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        if (!unixPath.empty()) {
+            net::local::stream_protocol::socket socket{ioc};
+            socket.connect(net::local::stream_protocol::endpoint(unixPath));
+            replay(socket, wire, loops, ticks.size());
+            return EXIT_SUCCESS;
+        }
+#endif
+        net::ip::tcp::socket socket{ioc};
+        socket.connect({net::ip::address_v4::loopback(), port});
+        replay(socket, wire, loops, ticks.size());
+    } catch (std::exception const& e) {
+        std::cerr << "[tick_replay] " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
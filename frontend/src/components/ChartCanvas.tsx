@@ -9,10 +9,15 @@ import {
 import { useResizeObserver } from '../hooks/useResizeObserver';
 import { useTheme } from '../ThemeProvider';
 import { DataPoint} from './ResizableChart'
+import { LiveSeries } from '../utils/liveSeries';
 export interface ChartCanvasProps {
   width: number;
   height: number;
   data: DataPoint[];
+  /** Server vertices drawn as is; replaces `data`, uploaded by dirty range */
+  live?: LiveSeries;
+  /** `live.version` at render time, so patches re-run the draw */
+  liveVersion?: number;
   title?: string;
   xLabel?: string;
   yLabel?: string;
@@ -62,6 +67,8 @@ const ChartCanvas: React.FC<ChartCanvasProps> = ({
   width,
   height,
   data,
+  live,
+  liveVersion,
   title,
   xLabel,
   yLabel,
@@ -75,6 +82,9 @@ const ChartCanvas: React.FC<ChartCanvasProps> = ({
   const canvasRef    = useRef<HTMLCanvasElement>(null);
   const progRef      = useRef<WebGLProgram|null>(null);
   const bufRef       = useRef<WebGLBuffer|null>(null);
+  // one GL buffer per live command, sized to its Float32Array's capacity
+  const liveBufsRef  = useRef<{ buf: WebGLBuffer; floats: number }[]>([]);
+  const glRef        = useRef<WebGLRenderingContext|null>(null);
   const {
     containerBackground,
     plotBackground,
@@ -91,10 +101,12 @@ const ChartCanvas: React.FC<ChartCanvasProps> = ({
   } = useTheme();
 
   // ─── Data domains & view state ───────────────────────────────────────
-  const rawXMin = useMemo(() => Math.min(...data.map(d=>d.x)), [data]);
-  const rawXMax = useMemo(() => Math.max(...data.map(d=>d.x)), [data]);
-  const rawYMin = useMemo(() => Math.min(...data.map(d=>d.y)), [data]);
-  const rawYMax = useMemo(() => Math.max(...data.map(d=>d.y)), [data]);
+  // Live series keep their bounds incrementally instead of rescanning
+  const liveBounds = useMemo(() => live?.bounds(), [live, liveVersion]);
+  const rawXMin = useMemo(() => liveBounds ? liveBounds.xMin : Math.min(...data.map(d=>d.x)), [data, liveBounds]);
+  const rawXMax = useMemo(() => liveBounds ? liveBounds.xMax : Math.max(...data.map(d=>d.x)), [data, liveBounds]);
+  const rawYMin = useMemo(() => liveBounds ? liveBounds.yMin : Math.min(...data.map(d=>d.y)), [data, liveBounds]);
+  const rawYMax = useMemo(() => liveBounds ? liveBounds.yMax : Math.max(...data.map(d=>d.y)), [data, liveBounds]);
 
   const [viewX, setViewX] = useState<[number,number]>([rawXMin, rawXMax]);
   const [viewY, setViewY] = useState<[number,number]>([rawYMin, rawYMax]);
@@ -138,9 +150,19 @@ const ChartCanvas: React.FC<ChartCanvasProps> = ({
     const gl = canvasRef.current.getContext('webgl');
     if (!gl) return;
 
+    // The canvas is remounted after a zero-size layout; GL objects of the
+    // old context are gone, so live buffers start over with a full upload
+    if (glRef.current !== gl) {
+      glRef.current       = gl;
+      progRef.current     = null;
+      liveBufsRef.current = [];
+    }
+
     // compile once
     if (!progRef.current) {
-      const vs = `attribute vec2 a_position; void main(){ gl_Position=vec4(a_position,0,1);} `;
+      // u_scale/u_offset map data to clip space, so live vertices upload once
+      const vs = `attribute vec2 a_position; uniform vec2 u_scale; uniform vec2 u_offset;
+        void main(){ gl_Position=vec4(a_position*u_scale+u_offset,0,1);} `;
       const fs = `precision mediump float; uniform vec4 u_color; void main(){ gl_FragColor=u_color;} `;
       function compile(type:number, src:string) {
         const sh = gl.createShader(type)!;
@@ -160,6 +182,47 @@ const ChartCanvas: React.FC<ChartCanvasProps> = ({
       bufRef.current  = gl.createBuffer();
     }
 
+    gl.viewport(0,0, innerW, innerH);
+    gl.clear(gl.COLOR_BUFFER_BIT);
+    gl.useProgram(progRef.current!);
+
+    const loc      = gl.getAttribLocation(progRef.current!, 'a_position');
+    const scaleLoc = gl.getUniformLocation(progRef.current!, 'u_scale')!;
+    const offLoc   = gl.getUniformLocation(progRef.current!, 'u_offset')!;
+    const colorLoc = gl.getUniformLocation(progRef.current!, 'u_color')!;
+    const [r,g,b,a] = hexToRgba(strokeColor);
+    gl.uniform4f(colorLoc, r, g, b, a);
+    gl.lineWidth(strokeWidth);
+    gl.enableVertexAttribArray(loc);
+
+    if (live) {
+      // Vertices are relative to the series origin; pan/zoom only moves uniforms
+      const sx = 2 / ((viewX[1] - viewX[0]) || 1), sy = 2 / (yMax - yMin);
+      gl.uniform2f(scaleLoc, sx, sy);
+      gl.uniform2f(offLoc, -1 - (viewX[0] - live.originX) * sx, -1 - (yMin - live.originY) * sy);
+
+      const bufs = liveBufsRef.current;
+      while (bufs.length > live.commands.length) gl.deleteBuffer(bufs.pop()!.buf);
+      live.commands.forEach((cmd, i) => {
+        if (!bufs[i]) bufs[i] = { buf: gl.createBuffer()!, floats: 0 };
+        const slot = bufs[i];
+        gl.bindBuffer(gl.ARRAY_BUFFER, slot.buf);
+        if (cmd.realloc || slot.floats < cmd.vertices.length) {
+          gl.bufferData(gl.ARRAY_BUFFER, cmd.vertices, gl.DYNAMIC_DRAW);
+          slot.floats = cmd.vertices.length;
+        } else if (cmd.dirtyStart < cmd.dirtyEnd) {
+          // Usually just the forming bar: a few floats, not the whole series
+          gl.bufferSubData(gl.ARRAY_BUFFER, cmd.dirtyStart * 4,
+                           cmd.vertices.subarray(cmd.dirtyStart, cmd.dirtyEnd));
+        }
+        live.uploaded(cmd);
+
+        gl.vertexAttribPointer(loc, 2, gl.FLOAT, false, 0, 0);
+        gl.drawArrays(cmd.seriesType === 'candlestick' ? gl.LINES : gl.LINE_STRIP, 0, cmd.length / 2);
+      });
+      return;
+    }
+
     // build normalized device coords
     const verts = new Float32Array(plotData.length * 2);
     plotData.forEach(({x,y},i) => {
@@ -168,22 +231,13 @@ const ChartCanvas: React.FC<ChartCanvasProps> = ({
       verts[2*i+1] = 1 - (py/innerH)*2;
     });
 
-    gl.viewport(0,0, innerW, innerH);
-    gl.clear(gl.COLOR_BUFFER_BIT);
-    gl.useProgram(progRef.current!);
+    gl.uniform2f(scaleLoc, 1, 1);
+    gl.uniform2f(offLoc, 0, 0);
     gl.bindBuffer(gl.ARRAY_BUFFER, bufRef.current!);
     gl.bufferData(gl.ARRAY_BUFFER, verts, gl.DYNAMIC_DRAW);
-
-    const loc = gl.getAttribLocation(progRef.current!, 'a_position');
-    gl.enableVertexAttribArray(loc);
     gl.vertexAttribPointer(loc, 2, gl.FLOAT, false, 0, 0);
-
-    const colorLoc = gl.getUniformLocation(progRef.current!, 'u_color')!;
-    const [r,g,b,a] = hexToRgba(strokeColor);
-    gl.uniform4f(colorLoc, r, g, b, a);
-    gl.lineWidth(strokeWidth);
     gl.drawArrays(gl.LINE_STRIP, 0, plotData.length);
-  }, [plotData, viewX, viewY, innerW, innerH, strokeColor, strokeWidth]);
+  }, [plotData, live, liveVersion, viewX, viewY, yMin, yMax, innerW, innerH, strokeColor, strokeWidth]);
 
   // ─── Event handlers ─────────────────────────────────────────────────
   const onWheel = (e: React.WheelEvent) => {
@@ -2,91 +2,98 @@
 import React, { useState, useEffect, useRef } from 'react';
 import ResizableChart from './ResizableChart';
 import { DataPoint } from './ResizableChart';
+import { getChartConnection } from '../utils/chartConnection';
+import { LiveSeries } from '../utils/liveSeries';
+import { ServerToClient } from '../types/protocol';
 
 type SeriesType = 'line' | 'candlestick';
 const WS_URL = process.env.REACT_APP_WS_URL ?? 'ws://localhost:9001';
+const NO_POINTS: DataPoint[] = [];
 
 interface ChartSubscriberProps {
   seriesType: SeriesType;
+  /** Live series id on the server; omit to chart the static data file */
+  source?: string;
+  /** Ask the server for frame latency tracing and ack each frame once drawn */
+  trace?: boolean;
 }
 
-const ChartSubscriber: React.FC<ChartSubscriberProps> = ({ seriesType }) => {
-  const [data, setData] = useState<DataPoint[]>([]);
-  const [ws, setWs] = useState<WebSocket | null>(null);
+const ChartSubscriber: React.FC<ChartSubscriberProps> = ({ seriesType, source, trace = false }) => {
+  // Live subscriptions draw server vertices straight from `live`; `version`
+  // re-renders the canvas, which uploads only the patched range
+  const [live] = useState(() => new LiveSeries());
+  const [version, setVersion] = useState(0);
   const [connected, setConnected] = useState(false);
   const [error, setError] = useState<string | null>(null);
 
   // track the latest animation frame id
   const rafRef = useRef<number | null>(null);
 
-  // Open one WebSocket per subscriber
+  // All charts share one multiplexed socket; track its status
   useEffect(() => {
-    const socket = new WebSocket(WS_URL);
-    socket.onopen   = () => { setConnected(true); setError(null); };
-    socket.onclose  = () => { setConnected(false); setError('WebSocket closed'); };
-    socket.onerror  = () => setError('WebSocket error');
-    setWs(socket);
-    return () => {
-      if (socket.readyState === WebSocket.OPEN) {
-        socket.send(JSON.stringify({ type: 'unsubscribe' }));
-      }
-      socket.close();
-    };
+    return getChartConnection(WS_URL).onStatus((isConnected, err) => {
+      setConnected(isConnected);
+      setError(err);
+    });
   }, []);
 
-  // Subscribe & handle messages with addEventListener + RAF throttle
+  // Subscribe this chart under its own id; frames arrive already filtered
   useEffect(() => {
-    if (!ws || !connected) return;
-
-    // our message handler
-    const onMessage = (ev: MessageEvent) => {
-      let pts: DataPoint[] = [];
-      try {
-        const msg = JSON.parse(ev.data);
-        // ignore messages for other series (if the protocol tags them)
-        if (msg.seriesType && msg.seriesType !== seriesType) return;
-        if (msg.type === 'drawCommands' && Array.isArray(msg.commands)) {
-          msg.commands.forEach((cmd: any) => {
-            if (Array.isArray(cmd.vertices)) {
-              for (let i = 0; i < cmd.vertices.length; i += 2) {
-                pts.push({ x: cmd.vertices[i], y: cmd.vertices[i + 1] });
-              }
-            }
-          });
+    const conn = getChartConnection(WS_URL);
+    // Set while waiting for the full frame a re-subscribe asked for
+    let resyncing = false;
+    const onFrame = (msg: ServerToClient) => {
+      if (msg.type === 'error') {
+        setError(msg.message);
+        return;
+      }
+      if (msg.type === 'drawCommands') {
+        resyncing = false;
+        live.reset(msg.commands);
+      } else if (msg.type === 'patchSeries') {
+        if (resyncing) return;
+        // Patches change a few floats in place; no per-vertex objects.
+        // One that does not fit means we missed a frame: ask for a full one
+        if (!live.patch(msg)) {
+          resyncing = true;
+          if (msg.subscriptionId !== undefined) conn.resubscribe(msg.subscriptionId);
+          return;
         }
-      } catch {
-        return; // on parse error just ignore
+      } else {
+        return;
       }
 
-      // throttle state updates to once per frame
+      // throttle state updates to once per frame; dirty ranges accumulate
       if (rafRef.current != null) cancelAnimationFrame(rafRef.current);
       rafRef.current = requestAnimationFrame(() => {
-        setData(pts);
+        setVersion(live.version);
         rafRef.current = null;
+        // Ack after the paint that shows this frame; frames skipped by the
+        // throttle are never acked and drop out of the server's histograms
+        if (trace) requestAnimationFrame(() => conn.ack(msg));
       });
     };
 
-    // make sure we’re unsubscribed, then subscribe this seriesType
-    ws.send(JSON.stringify({ type: 'unsubscribe' }));
-    ws.send(JSON.stringify({ type: 'subscribe', seriesTypes: [seriesType] }));
-    ws.addEventListener('message', onMessage);
+    const unsubscribe = conn.subscribe({ seriesType, source, trace, patch: true }, onFrame);
 
     return () => {
-      ws.send(JSON.stringify({ type: 'unsubscribe' }));
-      ws.removeEventListener('message', onMessage);
+      unsubscribe();
+      live.reset([]);
       if (rafRef.current != null) {
         cancelAnimationFrame(rafRef.current);
         rafRef.current = null;
       }
     };
-  }, [ws, connected, seriesType]);
+  }, [seriesType, source, trace, live]);
 
   if (error)      return <div style={{ color: 'red' }}>Error: {error}</div>;
   if (!connected) return <div>Connecting to {WS_URL}&hellip;</div>;
 
   return (
     <ResizableChart
-      data={data}
+      data={NO_POINTS}
+      live={live}
+      liveVersion={version}
       title={seriesType.toUpperCase()}
       xLabel="Time"
       yLabel="Price"
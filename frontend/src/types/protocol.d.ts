@@ -1,16 +1,91 @@
+/**
+ * Start streaming one chart. Several subscriptions can share a socket;
+ * every frame they produce carries the same `id` back as `subscriptionId`.
+ */
+export interface SubscribeRequest {
+  type: 'subscribe';
+  /** Client-chosen subscription id; re-using one replaces that subscription */
+  id?: string;
+  /** Which chart type to stream: line vs. candlestick */
+  seriesType?: 'line' | 'candlestick';
+  /** Several chart types in one subscription (rendered into one batch) */
+  seriesTypes?: ('line' | 'candlestick')[];
+  /** Live series id from the server's store (e.g. tick ingest); omit for the static data file */
+  source?: string;
+  /** Number frames with a monotonic `seq` */
+  seq?: boolean;
+  /** `seq` plus server stage timestamps; the client should `ack` each frame once drawn */
+  trace?: boolean;
+  /** Live sources only: after the first full frame, send `patchSeries` for changed bars */
+  patch?: boolean;
+  /** Live sources only: time window in ms (inclusive); open-ended when omitted */
+  from?: number;
+  to?: number;
+}
+
+/**
+ * Moves the time window of a live subscription (pan/zoom).
+ */
+export interface ViewportRequest {
+  type: 'viewport';
+  id: string;
+  from?: number;
+  to?: number;
+}
+
+/**
+ * Sent by tracing clients after a frame has been drawn.
+ */
+export interface AckRequest {
+  type: 'ack';
+  /** Subscription id */
+  id: string;
+  seq: number;
+}
+
+/**
+ * Asks for the latency histograms of this connection's traced subscriptions.
+ */
+export interface StatsRequest {
+  type: 'stats';
+  id?: string;
+}
+
+/**
+ * One-shot request for small PNG thumbnails of live series, rendered and
+ * cached server-side (e.g. for watchlists).
+ */
+export interface ThumbnailsRequest {
+  type: 'thumbnails';
+  /** Echoed back as `subscriptionId` on the reply */
+  id?: string;
+  /** Live series ids, one thumbnail each */
+  sources: string[];
+  seriesType?: 'line' | 'candlestick';
+  /** Pixel size; defaults to 120 x 40 */
+  width?: number;
+  height?: number;
+}
+
 /**
  * Messages sent from the client to the server
  * - subscribe: start streaming with a given series style
- * - unsubscribe: stop streaming
+ * - unsubscribe: stop one subscription (by id) or all of them; the socket stays open
+ * - thumbnails: render PNG thumbnails once
+ * - viewport: move a live subscription's time window
+ * - ack: a traced frame was drawn
+ * - stats: latency histograms for traced subscriptions
  */
 export type ClientToServer =
-  | {
-      type: 'subscribe';
-      /** Which chart type to stream: line vs. candlestick */
-      seriesType: 'line' | 'candlestick';
-    }
+  | SubscribeRequest
+  | ThumbnailsRequest
+  | ViewportRequest
+  | AckRequest
+  | StatsRequest
   | {
       type: 'unsubscribe';
+      /** Subscription to cancel; omit to cancel every subscription on the socket */
+      id?: string;
     };
 
 /**
@@ -71,5 +146,99 @@ export interface DrawSeriesCommand {
  */
 export interface DrawBatch {
   type: 'drawCommands';
+  /** Subscription this frame belongs to (absent for id-less subscribes) */
+  subscriptionId?: string;
+  /** Per-subscription frame number, when subscribed with `seq` or `trace` */
+  seq?: number;
   commands: DrawSeriesCommand[];
+  /** Server monotonic-clock stage timestamps in microseconds (0 = unknown) */
+  trace?: FrameTrace;
+}
+
+/**
+ * Replaces part of the vertices from the last `drawCommands` frame of a
+ * subscription; typically the forming bar.
+ */
+export interface SeriesPatchBatch {
+  type: 'patchSeries';
+  subscriptionId?: string;
+  seq?: number;
+  patches: Array<{
+    /** Position of the command in the last drawCommands frame */
+    index: number;
+    seriesId: string;
+    /** Float offset into that command's vertices; may extend past its end */
+    offset: number;
+    vertices: number[];
+  }>;
+  trace?: FrameTrace;
+}
+
+export interface FrameTrace {
+  ingest: number;
+  genStart: number;
+  genEnd: number;
+  enqueue: number;
+}
+
+/** Latency percentiles in microseconds */
+export interface LatencySummary {
+  count: number;
+  p50: number;
+  p90: number;
+  p99: number;
+  max: number;
+}
+
+/**
+ * Reply to a stats request.
+ */
+export interface Stats {
+  type: 'stats';
+  subscriptionId?: string;
+  subscriptions: Array<{
+    subscriptionId: string;
+    framesSent: number;
+    framesAcked: number;
+    /** Tick ingest to socket write complete */
+    pipeline: LatencySummary;
+    /** Socket write complete to client ack */
+    rtt: LatencySummary;
+    /** Tick ingest to client ack (tick to glass) */
+    endToEnd: LatencySummary;
+  }>;
+}
+
+/**
+ * Confirms that an `unsubscribe` with an id took effect.
+ */
+export interface Unsubscribed {
+  type: 'unsubscribed';
+  subscriptionId: string;
+}
+
+/**
+ * A request or subscription failed.
+ */
+export interface ErrorMessage {
+  type: 'error';
+  subscriptionId?: string;
+  message: string;
+}
+
+/**
+ * Reply to a thumbnails request, in request order.
+ */
+export interface Thumbnails {
+  type: 'thumbnails';
+  subscriptionId?: string;
+  images: Array<
+    | { source: string; /** Series version it was rendered from */ version: number; /** Base64 PNG */ png: string }
+    | { source: string; error: string }
+  >;
 }
+
+/**
+ * Messages sent from the server to the client
+ */
+export type ServerToClient = DrawBatch | SeriesPatchBatch | Unsubscribed | ErrorMessage | Thumbnails | Stats;
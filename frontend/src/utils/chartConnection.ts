@@ -0,0 +1,152 @@
+// frontend/src/utils/chartConnection.ts
+// One shared WebSocket per server URL, multiplexing every chart's subscription
+
+import { DrawBatch, SeriesPatchBatch, ServerToClient, SubscribeRequest, ThumbnailsRequest, Thumbnails } from '../types/protocol';
+
+type FrameHandler = (msg: ServerToClient) => void;
+type StatusHandler = (connected: boolean, error: string | null) => void;
+
+interface Entry {
+  /** Re-sent on reconnect while the entry is registered */
+  request: SubscribeRequest | ThumbnailsRequest;
+  onFrame: FrameHandler;
+}
+
+const RECONNECT_DELAY_MS = 1000;
+
+export class ChartConnection {
+  private ws: WebSocket | null = null;
+  private subs = new Map<string, Entry>();
+  private statusHandlers = new Set<StatusHandler>();
+  private nextId = 1;
+  private reconnectTimer: number | null = null;
+  connected = false;
+  error: string | null = null;
+
+  constructor(private readonly url: string) {}
+
+  /**
+   * Starts a subscription and returns its cancel function.
+   * The socket is opened on first use and closed when the last one cancels.
+   */
+  subscribe(request: Omit<SubscribeRequest, 'type' | 'id'>, onFrame: FrameHandler): () => void {
+    const id = this.register({ ...request, type: 'subscribe' }, onFrame);
+    return () => {
+      if (!this.subs.delete(id)) return;
+      this.sendIfOpen({ type: 'unsubscribe', id });
+      if (this.subs.size === 0) this.close();
+    };
+  }
+
+  /**
+   * Sends subscription `id`'s request again. The server replaces the
+   * subscription and starts over with a full drawCommands frame.
+   */
+  resubscribe(id: string) {
+    const entry = this.subs.get(id);
+    if (entry && entry.request.type === 'subscribe') this.sendIfOpen(entry.request);
+  }
+
+  /** Requests thumbnails once; resolves with the server's reply. */
+  requestThumbnails(request: Omit<ThumbnailsRequest, 'type' | 'id'>): Promise<Thumbnails> {
+    return new Promise((resolve, reject) => {
+      const id = this.register({ ...request, type: 'thumbnails' }, msg => {
+        this.subs.delete(id);
+        if (this.subs.size === 0) this.close();
+        if (msg.type === 'thumbnails') resolve(msg);
+        else reject(new Error(msg.type === 'error' ? msg.message : 'Unexpected reply'));
+      });
+    });
+  }
+
+  private register(request: SubscribeRequest | ThumbnailsRequest, onFrame: FrameHandler): string {
+    const id = `s${this.nextId++}`;
+    const entry: Entry = { request: { ...request, id }, onFrame };
+    this.subs.set(id, entry);
+    this.ensureOpen();
+    this.sendIfOpen(entry.request);
+    return id;
+  }
+
+  /** Tells the server a traced frame has been drawn. */
+  ack(msg: DrawBatch | SeriesPatchBatch) {
+    if (msg.subscriptionId === undefined || msg.seq === undefined) return;
+    this.sendIfOpen({ type: 'ack', id: msg.subscriptionId, seq: msg.seq });
+  }
+
+  onStatus(handler: StatusHandler): () => void {
+    this.statusHandlers.add(handler);
+    handler(this.connected, this.error);
+    return () => { this.statusHandlers.delete(handler); };
+  }
+
+  private ensureOpen() {
+    if (this.ws) return;
+    const socket = new WebSocket(this.url);
+    this.ws = socket;
+
+    socket.onopen = () => {
+      this.setStatus(true, null);
+      // (Re)establish every live subscription on the new socket
+      this.subs.forEach(entry => socket.send(JSON.stringify(entry.request)));
+    };
+    socket.onmessage = (ev: MessageEvent) => {
+      let msg: ServerToClient;
+      try {
+        msg = JSON.parse(ev.data);
+      } catch {
+        return; // on parse error just ignore
+      }
+      const id = (msg as { subscriptionId?: string }).subscriptionId;
+      if (id === undefined) return;
+      this.subs.get(id)?.onFrame(msg);
+    };
+    socket.onerror = () => this.setStatus(this.connected, 'WebSocket error');
+    socket.onclose = () => {
+      if (this.ws !== socket) return;
+      this.ws = null;
+      this.setStatus(false, 'WebSocket closed');
+      if (this.subs.size > 0 && this.reconnectTimer == null) {
+        this.reconnectTimer = window.setTimeout(() => {
+          this.reconnectTimer = null;
+          if (this.subs.size > 0) this.ensureOpen();
+        }, RECONNECT_DELAY_MS);
+      }
+    };
+  }
+
+  private close() {
+    if (this.reconnectTimer != null) {
+      window.clearTimeout(this.reconnectTimer);
+      this.reconnectTimer = null;
+    }
+    const socket = this.ws;
+    this.ws = null;
+    socket?.close();
+    this.setStatus(false, null);
+  }
+
+  private sendIfOpen(msg: object) {
+    if (this.ws && this.ws.readyState === WebSocket.OPEN) {
+      this.ws.send(JSON.stringify(msg));
+    }
+  }
+
+  private setStatus(connected: boolean, error: string | null) {
+    this.connected = connected;
+    this.error = error;
+    this.statusHandlers.forEach(h => h(connected, error));
+  }
+}
+
+const connections = new Map<string, ChartConnection>();
+
+/** Returns the shared connection for `url`, creating it on first use. */
+export function getChartConnection(url: string): ChartConnection {
+  let conn = connections.get(url);
+  if (!conn) {
+    conn = new ChartConnection(url);
+    connections.set(url, conn);
+  }
+  return conn;
+}
@@ -0,0 +1,155 @@
+// frontend/src/utils/liveSeries.ts
+// Vertex buffers of one live subscription, patched in place and uploaded by dirty range
+
+import { DrawSeriesCommand, SeriesPatchBatch } from '../types/protocol';
+
+export interface SeriesBounds { xMin: number; xMax: number; yMin: number; yMax: number; }
+
+/** Vertices of one draw command, as uploaded to its GL buffer */
+export interface LiveCommand {
+  /** 'line' draws a strip, 'candlestick' independent segments */
+  seriesType: string;
+  /** [x, y, …] relative to the series origin; capacity may exceed `length` */
+  vertices: Float32Array;
+  /** Floats in use */
+  length: number;
+  /** Float range changed since the last upload; start >= end when clean */
+  dirtyStart: number;
+  dirtyEnd: number;
+  /** Buffer was replaced or outgrew the GL buffer: upload all of it */
+  realloc: boolean;
+}
+
+/**
+ * The last drawCommands frame of a subscription plus the patches since.
+ *
+ * Vertices are stored relative to the first vertex of the frame, so raw
+ * millisecond timestamps keep their precision in Float32. A patch writes
+ * only its floats and widens the command's dirty range; the canvas then
+ * uploads that range with bufferSubData instead of the whole series.
+ */
+export class LiveSeries {
+  commands: LiveCommand[] = [];
+  originX = 0;
+  originY = 0;
+  /** Bumped on every change, for React dependencies */
+  version = 0;
+
+  private cachedBounds: SeriesBounds | null = null;
+
+  /** Replaces everything with a full frame */
+  reset(commands: DrawSeriesCommand[]): void {
+    const first = commands.find(c => c.vertices.length >= 2);
+    this.originX = first ? first.vertices[0] : 0;
+    this.originY = first ? first.vertices[1] : 0;
+    this.commands = commands.map(cmd => {
+      const src = Array.isArray(cmd.vertices) ? cmd.vertices : [];
+      const vertices = new Float32Array(src.length);
+      this.write(vertices, 0, src);
+      return {
+        seriesType: cmd.style?.type ?? 'line',
+        vertices,
+        length: src.length,
+        dirtyStart: 0,
+        dirtyEnd: src.length,
+        realloc: true,
+      };
+    });
+    this.cachedBounds = null;
+    this.version++;
+  }
+
+  /**
+   * Applies a patch frame; returns false if it does not fit the last full
+   * frame (unknown command, or a gap past its end), and the caller must get
+   * a new one
+   */
+  patch(msg: SeriesPatchBatch): boolean {
+    for (const p of msg.patches) {
+      const cmd = this.commands[p.index];
+      if (!cmd || p.offset > cmd.length) return false;
+      const end = p.offset + p.vertices.length;
+      if (end > cmd.vertices.length) {
+        // Appended bars: grow geometrically so appends stay amortized O(1)
+        const grown = new Float32Array(Math.max(end, cmd.vertices.length * 2));
+        grown.set(cmd.vertices.subarray(0, cmd.length));
+        cmd.vertices = grown;
+        cmd.realloc = true;
+      }
+      // Overwritten vertices, to see whether the bounds pulled back
+      const before = this.cachedBounds
+        ? cmd.vertices.slice(p.offset, Math.min(cmd.length, end))
+        : null;
+      this.write(cmd.vertices, p.offset, p.vertices);
+      if (before && this.shrinks(before, cmd.vertices.subarray(p.offset), p.offset)) {
+        this.cachedBounds = null;
+      }
+      cmd.length = Math.max(cmd.length, end);
+      if (cmd.dirtyStart >= cmd.dirtyEnd) {
+        cmd.dirtyStart = p.offset;
+        cmd.dirtyEnd = end;
+      } else {
+        cmd.dirtyStart = Math.min(cmd.dirtyStart, p.offset);
+        cmd.dirtyEnd = Math.max(cmd.dirtyEnd, end);
+      }
+      if (this.cachedBounds) this.extend(this.cachedBounds, cmd, p.offset, end);
+    }
+    this.version++;
+    return true;
+  }
+
+  /** Called by the canvas once a command's dirty range is on the GPU */
+  uploaded(cmd: LiveCommand): void {
+    cmd.dirtyStart = cmd.dirtyEnd = 0;
+    cmd.realloc = false;
+  }
+
+  /** Absolute data bounds; recomputed only when a patch may have shrunk them */
+  bounds(): SeriesBounds {
+    if (!this.cachedBounds) {
+      const b = { xMin: Infinity, xMax: -Infinity, yMin: Infinity, yMax: -Infinity };
+      for (const cmd of this.commands) {
+        for (let i = 0; i + 1 < cmd.length; i += 2) {
+          const x = cmd.vertices[i] + this.originX, y = cmd.vertices[i + 1] + this.originY;
+          if (x < b.xMin) b.xMin = x;
+          if (x > b.xMax) b.xMax = x;
+          if (y < b.yMin) b.yMin = y;
+          if (y > b.yMax) b.yMax = y;
+        }
+      }
+      this.cachedBounds = b;
+    }
+    return this.cachedBounds;
+  }
+
+  private write(dst: Float32Array, offset: number, src: number[]): void {
+    for (let i = 0; i < src.length; i++) {
+      dst[offset + i] = src[i] - ((offset + i) % 2 === 0 ? this.originX : this.originY);
+    }
+  }
+
+  // Widens `b` by the stored (Float32-rounded) vertices in [start, end)
+  private extend(b: SeriesBounds, cmd: LiveCommand, start: number, end: number): void {
+    for (let i = start - (start % 2); i + 1 < end; i += 2) {
+      const x = cmd.vertices[i] + this.originX, y = cmd.vertices[i + 1] + this.originY;
+      if (x < b.xMin) b.xMin = x;
+      if (x > b.xMax) b.xMax = x;
+      if (y < b.yMin) b.yMin = y;
+      if (y > b.yMax) b.yMax = y;
+    }
+  }
+
+  // True if a value that sat on a bound was replaced by one inside it, e.g.
+  // the forming bar falling back from the high; only then is a rescan needed
+  private shrinks(before: Float32Array, after: Float32Array, offset: number): boolean {
+    const b = this.cachedBounds!;
+    for (let i = 0; i < before.length; i++) {
+      const isX = (offset + i) % 2 === 0;
+      const origin = isX ? this.originX : this.originY;
+      const was = before[i] + origin, now = after[i] + origin;
+      const lo = isX ? b.xMin : b.yMin, hi = isX ? b.xMax : b.yMax;
+      if ((was === lo && now > lo) || (was === hi && now < hi)) return true;
+    }
+    return false;
+  }
+}